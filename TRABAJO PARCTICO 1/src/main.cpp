@@ -1,9 +1,11 @@
 #include <Arduino.h>
-#include <Wire.h>
-#include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
-#include <DHT.h>
 #include "esp_system.h" 
+#include "greenhouse_core.h"
+#include "gh_sensor.h"
+#include "gh_pot.h"
+#include "gh_display.h"
+#include "gh_output.h"
+#include "gh_commands.h"
 
 // Pines
 #define DHTPIN         4
@@ -15,37 +17,42 @@
 #define SDA_PIN        21
 #define SCL_PIN        22
 
-// OLED
-#define SCREEN_WIDTH 128
-#define SCREEN_HEIGHT 64
-#define OLED_RESET    -1
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
-
-// DHT
-DHT dht(DHTPIN, DHTTYPE);
-
 // Tiempos
 const unsigned long DHT_INTERVAL = 2000;
 const unsigned long BLINK_INTERVAL = 500; 
 const unsigned long DISPLAY_INTERVAL = 700;
 
 unsigned long lastDHTRead = 0;
-unsigned long lastBlink = 0;
 unsigned long lastDisplayUpdate = 0;
 
+// Nucleo compartido (lib/greenhouse_core): DHT, pote, OLED, LEDs y comandos
+struct Actuators {
+  DigitalOutput<LED_VENT_PIN> vent;
+  BlinkOutput<LED_RIEGO_PIN, BLINK_INTERVAL> riego;  // parpadea mientras riega
+  void begin() { vent.begin(); riego.begin(); }
+  void loop(unsigned long now) { riego.loop(now); }
+};
+
+GreenhouseCore<Dht22Sensor<DHTPIN, DHTTYPE>, AnalogPot<POT_PIN>,
+               Ssd1306Display<SDA_PIN, SCL_PIN>, Actuators,
+               SerialCommands<48, true>> core;
+
+// OLED (las pantallas del menu se dibujan aca)
+Adafruit_SSD1306& display = core.display.gfx();
+
 // Estados y lecturas
-float currentTemp = NAN;
-float currentHum = NAN;
-float tempReference = 25.0;
+// Temperatura y humedad en centesimas (ver fixed_point.h)
+centi_t currentTemp = CENTI_NAN;
+centi_t currentHum = CENTI_NAN;
+centi_t tempReference = 2500;
 int humThreshold = 50;
 bool ventState = false;
 bool prevVentState = false;
 bool watering = false;
 bool prevWatering = false;
-bool blinkLedState = false;
 
 // Histeresis
-const float VENT_HYST = 0.5f;
+const centi_t VENT_HYST = 50; // 0.5 C
 
 // Sistema de menú
 enum MenuState {
@@ -79,28 +86,128 @@ void logEvent(const char* msg) {
   Serial.println(msg);
 }
 
+// Imprime un valor en centesimas sin pasar por printf de floats
+void printCenti(Print& out, int32_t v, uint8_t decimals = 1) {
+  char buf[16];
+  centiToStr(buf, v, decimals);
+  out.print(buf);
+}
+
+// --------------------- Comandos por Serial ---------------------
+void cmdTemp(const char* args) {
+  int32_t newTemp;
+  if (parseCenti(args, newTemp) && newTemp >= 1000 && newTemp <= 5000) {
+    tempReference = newTemp;
+    Serial.print("Temperatura de referencia configurada a: ");
+    printCenti(Serial, newTemp);
+    Serial.println(" °C");
+    menuChanged = true;
+  } else {
+    Serial.println("Error: Temperatura debe estar entre 10-50°C");
+  }
+}
+
+void cmdHum(const char* args) {
+  int newHum = atoi(args);
+  if (newHum >= 40 && newHum <= 60) {
+    humThreshold = newHum;
+    Serial.print("Umbral de humedad configurado a: ");
+    Serial.print(newHum);
+    Serial.println("%");
+    menuChanged = true;
+  } else {
+    Serial.println("Error: Humedad debe estar entre 40-60%");
+  }
+}
+
+void cmdVentOn(const char*) {
+  manualVentOverride = true;
+  ventState = true;
+  Serial.println("Ventilación activada manualmente");
+  menuChanged = true;
+}
+
+void cmdVentOff(const char*) {
+  manualVentOverride = true;
+  ventState = false;
+  Serial.println("Ventilación desactivada manualmente");
+  menuChanged = true;
+}
+
+void cmdRiegoOn(const char*) {
+  manualRiegoOverride = true;
+  watering = true;
+  Serial.println("Riego activado manualmente");
+  menuChanged = true;
+}
+
+void cmdRiegoOff(const char*) {
+  manualRiegoOverride = true;
+  watering = false;
+  Serial.println("Riego desactivado manualmente");
+  menuChanged = true;
+}
+
+void cmdAuto(const char*) {
+  manualVentOverride = false;
+  manualRiegoOverride = false;
+  Serial.println("Modo automático activado");
+  menuChanged = true;
+}
+
+void cmdStatus(const char*) {
+  Serial.println("\n=== ESTADO COMPLETO DEL INVERNADERO ===");
+  if (centiValid(currentTemp)) {
+    Serial.print("Temperatura actual: ");
+    printCenti(Serial, currentTemp);
+    Serial.println(" °C");
+  } else {
+    Serial.println("Temperatura actual: --.- °C");
+  }
+  if (centiValid(currentHum)) {
+    Serial.print("Humedad actual: ");
+    printCenti(Serial, currentHum);
+    Serial.println(" %");
+  } else {
+    Serial.println("Humedad actual: --.- %");
+  }
+  Serial.print("Temperatura de referencia: ");
+  printCenti(Serial, tempReference);
+  Serial.println(" °C");
+  Serial.print("Umbral de humedad: ");
+  Serial.print(humThreshold);
+  Serial.println(" %");
+  Serial.print("Ventilación: ");
+  Serial.println(ventState ? "ACTIVA" : "INACTIVA");
+  Serial.print("Riego: ");
+  Serial.println(watering ? "ACTIVO" : "INACTIVO");
+  Serial.println("=====================================\n");
+}
+
+void unknownCommand(const char*) {
+  Serial.println("Comando no reconocido. Escriba HELP para ver comandos disponibles.");
+}
+
+const CommandEntry SERIAL_COMMANDS[] = {
+  { "TEMP ", cmdTemp },
+  { "HUM ", cmdHum },
+  { "VENT ON", cmdVentOn },
+  { "VENT OFF", cmdVentOff },
+  { "RIEGO ON", cmdRiegoOn },
+  { "RIEGO OFF", cmdRiegoOff },
+  { "AUTO", cmdAuto },
+  { "STATUS", cmdStatus },
+};
+
 void setup() {
   Serial.begin(115200);
   delay(100);
 
-  // I2C
-  Wire.begin(SDA_PIN, SCL_PIN);
-
-  // OLED init
-  if (!display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
+  // I2C + OLED, DHT, pote (ADC 11 dB), salidas y comandos por Serial
+  core.commands.setTable(SERIAL_COMMANDS, unknownCommand);
+  if (!core.begin()) {
     Serial.println("ERROR: No se encontro OLED");
   }
-  display.clearDisplay();
-  display.setTextColor(SSD1306_WHITE);
-
-  // DHT
-  dht.begin();
-
-  // Pines salidas
-  pinMode(LED_VENT_PIN, OUTPUT);
-  digitalWrite(LED_VENT_PIN, LOW);
-  pinMode(LED_RIEGO_PIN, OUTPUT);
-  digitalWrite(LED_RIEGO_PIN, LOW);
 
   // configuracion del botón
   pinMode(BUTTON_PIN, INPUT_PULLUP);
@@ -111,11 +218,6 @@ void setup() {
   Serial.print("Button init reading: ");
   Serial.println(lastButtonReading);
 
-  // Configurar ADC del potenciómetro
-  #if defined(ARDUINO_ARCH_ESP32)
-    analogSetPinAttenuation(POT_PIN, ADC_11db);
-  #endif
-
   // Semilla aleatoria
   randomSeed((uint32_t)esp_random());
 
@@ -169,9 +271,9 @@ void updateDisplay() {
       display.println("TEMPERATURA");
       display.setTextSize(2);
       display.setCursor(0, 18);
-      if (!isnan(currentTemp)) {
+      if (centiValid(currentTemp)) {
         display.print("T: ");
-        display.print(currentTemp, 1);
+        printCenti(display, currentTemp);
         display.print(" C");
       } else {
         display.print("T: --.- C");
@@ -179,7 +281,7 @@ void updateDisplay() {
       display.setTextSize(1);
       display.setCursor(0, 42);
       display.print("Ref:");
-      display.print(tempReference, 1);
+      printCenti(display, tempReference);
       display.print(" C");
       display.setCursor(0, 54);
       display.print("Vent: ");
@@ -190,9 +292,9 @@ void updateDisplay() {
       display.println("HUMEDAD");
       display.setTextSize(2);
       display.setCursor(0, 18);
-      if (!isnan(currentHum)) {
+      if (centiValid(currentHum)) {
         display.print("H: ");
-        display.print(currentHum, 1);
+        printCenti(display, currentHum);
         display.print(" %");
       } else {
         display.print("H: --.- %");
@@ -208,24 +310,24 @@ void updateDisplay() {
       display.println("ESTADO COMPLETO");
       display.setTextSize(1);
       display.setCursor(0, 12);
-      if (!isnan(currentTemp)) {
+      if (centiValid(currentTemp)) {
         display.print("Temp: ");
-        display.print(currentTemp, 1);
+        printCenti(display, currentTemp);
         display.println(" C");
       } else {
         display.println("Temp: --.- C");
       }
       display.setCursor(0, 24);
-      if (!isnan(currentHum)) {
+      if (centiValid(currentHum)) {
         display.print("Hum:  ");
-        display.print(currentHum, 1);
+        printCenti(display, currentHum);
         display.println(" %");
       } else {
         display.println("Hum:  --.- %");
       }
       display.setCursor(0, 36);
       display.print("Ref Temp:");
-      display.print(tempReference, 1);
+      printCenti(display, tempReference);
       display.println(" C");
       display.setCursor(0, 48);
       display.print("Umbral:");
@@ -243,7 +345,7 @@ void updateDisplay() {
       display.setTextSize(2);
       display.setCursor(0, 18);
       display.print("Ref:");
-      display.print(tempReference, 1);
+      printCenti(display, tempReference);
       display.println(" C");
       display.setTextSize(1);
       display.setCursor(0, 42);
@@ -254,9 +356,9 @@ void updateDisplay() {
       display.println("CONFIG HUMEDAD");
       display.setTextSize(2);
       display.setCursor(0, 18);
-      if (!isnan(currentHum)) {
+      if (centiValid(currentHum)) {
         display.print("H: ");
-        display.print(currentHum, 1);
+        printCenti(display, currentHum);
         display.print(" %");
       } else {
         display.print("H: --.- %");
@@ -302,9 +404,8 @@ void readSensors() {
   unsigned long now = millis();
   if (now - lastDHTRead >= DHT_INTERVAL) {
     lastDHTRead = now;
-    float h = dht.readHumidity();
-    float t = dht.readTemperature();
-    if (isnan(h) || isnan(t)) {
+    centi_t t, h;
+    if (!core.readSensor(t, h)) {
       Serial.println("Warning: lectura DHT fallida");
     } else {
       currentHum = h;
@@ -313,12 +414,12 @@ void readSensors() {
     }
 
     // Lectura potenciómetro
-    int potRaw = analogRead(POT_PIN);
+    int potRaw = core.pot.raw();
     
     // Modificacion de variables segun opcion del menú
     if (currentMenu == MENU_CONFIG_HUM) {
       //Simular humedad modificada
-      currentHum = (potRaw / 4095.0f) * 20.0f + 40.0f;
+      currentHum = core.pot.toRange(potRaw, 4000, 6000);
       manualRiegoOverride = false;
     } else if (currentMenu == MENU_MANUAL_RIEGO) {
       //control manual de riego
@@ -334,7 +435,7 @@ void readSensors() {
       manualVentOverride = true;
       ventState = (potRaw > 2047);
     } else if (currentMenu == MENU_CONFIG_TEMP) {
-      tempReference = (potRaw / 4095.0f) * 40.0f + 10.0f;
+      tempReference = core.pot.toRange(potRaw, 1000, 5000);
     }
     sensorsUpdated = true;
   }
@@ -347,7 +448,7 @@ void handleVentilationAndIrrigation() {
     newVentState = ventState;
   } else {
     // Control automático con histeresis
-    if (!isnan(currentTemp)) {
+    if (centiValid(currentTemp)) {
       if (currentTemp > tempReference + VENT_HYST) {
         newVentState = true;
       } else if (currentTemp < tempReference - VENT_HYST) {
@@ -365,7 +466,7 @@ void handleVentilationAndIrrigation() {
     prevVentState = newVentState;
   }
   ventState = newVentState;
-  digitalWrite(LED_VENT_PIN, ventState ? HIGH : LOW);
+  core.actuators.vent.set(ventState);
 
   // Riego automático - manual
   bool shouldWater = false;
@@ -374,8 +475,8 @@ void handleVentilationAndIrrigation() {
     shouldWater = watering;
   } else {
     // Control automático
-    if (!isnan(currentHum)) {
-      shouldWater = (currentHum < (float)humThreshold);
+    if (centiValid(currentHum)) {
+      shouldWater = (currentHum < humThreshold * 100);
     }
   }
   
@@ -384,23 +485,12 @@ void handleVentilationAndIrrigation() {
     Serial.println("Evento: RIEGO ACTIVADO (humedad por debajo del umbral)");
   } else if (!shouldWater && prevWatering) {
     Serial.println("Evento: RIEGO DETENIDO (humedad OK)");
-    digitalWrite(LED_RIEGO_PIN, LOW);
-    blinkLedState = false;
   }
   watering = shouldWater;
   prevWatering = shouldWater;
 
-  // parpadeo
-  if (watering) {
-    unsigned long now = millis();
-    if (now - lastBlink >= BLINK_INTERVAL) {
-      lastBlink = now;
-      blinkLedState = !blinkLedState;
-      digitalWrite(LED_RIEGO_PIN, blinkLedState ? HIGH : LOW);
-    }
-  } else {
-    digitalWrite(LED_RIEGO_PIN, LOW);
-  }
+  // parpadeo (lo hace core.loop)
+  core.actuators.riego.set(watering);
 }
 
 void handleButton() {
@@ -435,105 +525,12 @@ void handleButton() {
   }
 }
 
-void handleSerialCommands() {
-  if (Serial.available()) {
-    String command = Serial.readStringUntil('\n');
-    command.trim();
-    command.toUpperCase();
-    
-    if (command.startsWith("TEMP ")) {
-      float newTemp = command.substring(5).toFloat();
-      if (newTemp >= 10.0 && newTemp <= 50.0) {
-        tempReference = newTemp;
-        Serial.print("Temperatura de referencia configurada a: ");
-        Serial.print(newTemp, 1);
-        Serial.println(" °C");
-        menuChanged = true;
-      } else {
-        Serial.println("Error: Temperatura debe estar entre 10-50°C");
-      }
-    }
-    else if (command.startsWith("HUM ")) {
-      int newHum = command.substring(4).toInt();
-      if (newHum >= 40 && newHum <= 60) {
-        humThreshold = newHum;
-        Serial.print("Umbral de humedad configurado a: ");
-        Serial.print(newHum);
-        Serial.println("%");
-        menuChanged = true;
-      } else {
-        Serial.println("Error: Humedad debe estar entre 40-60%");
-      }
-    }
-    else if (command == "VENT ON") {
-      manualVentOverride = true;
-      ventState = true;
-      Serial.println("Ventilación activada manualmente");
-      menuChanged = true;
-    }
-    else if (command == "VENT OFF") {
-      manualVentOverride = true;
-      ventState = false;
-      Serial.println("Ventilación desactivada manualmente");
-      menuChanged = true;
-    }
-    else if (command == "RIEGO ON") {
-      manualRiegoOverride = true;
-      watering = true;
-      Serial.println("Riego activado manualmente");
-      menuChanged = true;
-    }
-    else if (command == "RIEGO OFF") {
-      manualRiegoOverride = true;
-      watering = false;
-      Serial.println("Riego desactivado manualmente");
-      menuChanged = true;
-    }
-    else if (command == "AUTO") {
-      manualVentOverride = false;
-      manualRiegoOverride = false;
-      Serial.println("Modo automático activado");
-      menuChanged = true;
-    }
-    else if (command == "STATUS") {
-      Serial.println("\n=== ESTADO COMPLETO DEL INVERNADERO ===");
-      if (!isnan(currentTemp)) {
-        Serial.print("Temperatura actual: ");
-        Serial.print(currentTemp, 1);
-        Serial.println(" °C");
-      } else {
-        Serial.println("Temperatura actual: --.- °C");
-      }
-      if (!isnan(currentHum)) {
-        Serial.print("Humedad actual: ");
-        Serial.print(currentHum, 1);
-        Serial.println(" %");
-      } else {
-        Serial.println("Humedad actual: --.- %");
-      }
-      Serial.print("Temperatura de referencia: ");
-      Serial.print(tempReference, 1);
-      Serial.println(" °C");
-      Serial.print("Umbral de humedad: ");
-      Serial.print(humThreshold);
-      Serial.println(" %");
-      Serial.print("Ventilación: ");
-      Serial.println(ventState ? "ACTIVA" : "INACTIVA");
-      Serial.print("Riego: ");
-      Serial.println(watering ? "ACTIVO" : "INACTIVO");
-      Serial.println("=====================================\n");
-    }
-    else if (command.length() > 0) {
-      Serial.println("Comando no reconocido. Escriba HELP para ver comandos disponibles.");
-    }
-  }
-}
-
 void loop() {
   readSensors();
   handleVentilationAndIrrigation();
   handleButton();
-  handleSerialCommands();
+  // Comandos por Serial y parpadeo del riego
+  core.loop(millis());
 
   // Actualizar display
   if (sensorsUpdated || menuChanged || (millis() - lastDisplayUpdate >= DISPLAY_INTERVAL)) {
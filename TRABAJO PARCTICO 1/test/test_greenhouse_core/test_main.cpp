@@ -0,0 +1,315 @@
+/* Tests nativos de lib/greenhouse_core (pio test -e native)
+   Arduino.h es el stub de lib/greenhouse_core/native: Serial, pines y
+   analogRead simulados.
+*/
+#include <Arduino.h>
+#include <unity.h>
+
+#include <type_traits>
+
+#include "fixed_point.h"
+#include "gh_commands.h"
+#include "gh_output.h"
+#include "gh_pot.h"
+#include "greenhouse_core.h"
+
+static char buf[16];
+
+void setUp() {
+  Serial.reset();
+  memset(pinLevel, 0, sizeof(pinLevel));
+  memset(analogValue, 0, sizeof(analogValue));
+}
+
+void tearDown() {}
+
+// --------------------- fixed_point ---------------------
+static void test_centi_to_str() {
+  TEST_ASSERT_EQUAL(4, centiToStr(buf, 2534));
+  TEST_ASSERT_EQUAL_STRING("25.3", buf);
+  centiToStr(buf, 2534, 2);
+  TEST_ASSERT_EQUAL_STRING("25.34", buf);
+  centiToStr(buf, 2500, 0);
+  TEST_ASSERT_EQUAL_STRING("25", buf);
+  centiToStr(buf, 0);
+  TEST_ASSERT_EQUAL_STRING("0.0", buf);
+}
+
+static void test_centi_to_str_rounding() {
+  centiToStr(buf, 2555);
+  TEST_ASSERT_EQUAL_STRING("25.6", buf);
+  centiToStr(buf, 2549);
+  TEST_ASSERT_EQUAL_STRING("25.5", buf);
+  centiToStr(buf, 995);
+  TEST_ASSERT_EQUAL_STRING("10.0", buf);
+  fixedToStr(buf, 12345, 3, 2);
+  TEST_ASSERT_EQUAL_STRING("12.35", buf);
+}
+
+static void test_centi_to_str_negative() {
+  centiToStr(buf, -250);
+  TEST_ASSERT_EQUAL_STRING("-2.5", buf);
+  centiToStr(buf, -255);
+  TEST_ASSERT_EQUAL_STRING("-2.6", buf);
+  centiToStr(buf, -5);
+  TEST_ASSERT_EQUAL_STRING("-0.1", buf);
+  // Redondea a cero: sin "-0.0"
+  centiToStr(buf, -4);
+  TEST_ASSERT_EQUAL_STRING("0.0", buf);
+  centiToStr(buf, INT16_MIN + 1, 2);
+  TEST_ASSERT_EQUAL_STRING("-327.67", buf);
+}
+
+static void test_parse_centi() {
+  int32_t v = 0;
+  TEST_ASSERT_TRUE(parseCenti("25", v));
+  TEST_ASSERT_EQUAL(2500, v);
+  TEST_ASSERT_TRUE(parseCenti("25.5", v));
+  TEST_ASSERT_EQUAL(2550, v);
+  TEST_ASSERT_TRUE(parseCenti("25,5", v));
+  TEST_ASSERT_EQUAL(2550, v);
+  TEST_ASSERT_TRUE(parseCenti(" 7.129 ", v));
+  TEST_ASSERT_EQUAL(712, v);
+  TEST_ASSERT_TRUE(parseCenti("-3.25", v));
+  TEST_ASSERT_EQUAL(-325, v);
+  TEST_ASSERT_TRUE(parseCenti("-.5", v));
+  TEST_ASSERT_EQUAL(-50, v);
+  TEST_ASSERT_TRUE(parseCenti("+4", v));
+  TEST_ASSERT_EQUAL(400, v);
+}
+
+static void test_parse_centi_rejects() {
+  int32_t v = 1234;
+  TEST_ASSERT_FALSE(parseCenti("", v));
+  TEST_ASSERT_FALSE(parseCenti("-", v));
+  TEST_ASSERT_FALSE(parseCenti("abc", v));
+  TEST_ASSERT_FALSE(parseCenti("25.5x", v));
+  TEST_ASSERT_FALSE(parseCenti("1234567", v));
+  TEST_ASSERT_EQUAL(1234, v);
+}
+
+// --------------------- SerialCommands ---------------------
+static char lastCmd[16];
+static char lastArgs[48];
+static char lastUnknown[48];
+static int calls;
+
+static void record(const char* name, const char* args) {
+  strncpy(lastCmd, name, sizeof(lastCmd) - 1);
+  strncpy(lastArgs, args, sizeof(lastArgs) - 1);
+  calls++;
+}
+
+static void cmdTemp(const char* args) { record("TEMP", args); }
+static void cmdVentOn(const char* args) { record("VENT ON", args); }
+static void cmdStatus(const char* args) { record("STATUS", args); }
+static void cmdUnknown(const char* line) { strncpy(lastUnknown, line, sizeof(lastUnknown) - 1); }
+
+static const CommandEntry COMMANDS[] = {
+  {"TEMP ", cmdTemp},
+  {"VENT ON", cmdVentOn},
+  {"STATUS", cmdStatus},
+};
+
+template <class Commands>
+static void resetCommands(Commands& c) {
+  memset(lastCmd, 0, sizeof(lastCmd));
+  memset(lastArgs, 0, sizeof(lastArgs));
+  memset(lastUnknown, 0, sizeof(lastUnknown));
+  calls = 0;
+  c.setTable(COMMANDS, cmdUnknown);
+  c.begin();
+}
+
+static void test_commands_exact_and_prefix() {
+  SerialCommands<> c;
+  resetCommands(c);
+
+  Serial.feed("STATUS\n");
+  c.loop(0);
+  TEST_ASSERT_EQUAL_STRING("STATUS", lastCmd);
+  TEST_ASSERT_EQUAL_STRING("", lastArgs);
+
+  Serial.feed("  TEMP 25.5  \n");
+  c.loop(0);
+  TEST_ASSERT_EQUAL_STRING("TEMP", lastCmd);
+  TEST_ASSERT_EQUAL_STRING("25.5", lastArgs);
+
+  // Exacto: con texto de mas no coincide
+  Serial.feed("STATUS 1\n");
+  c.loop(0);
+  TEST_ASSERT_EQUAL_STRING("STATUS 1", lastUnknown);
+  // Prefijo: sin el espacio no coincide
+  Serial.feed("TEMP\n");
+  c.loop(0);
+  TEST_ASSERT_EQUAL_STRING("TEMP", lastUnknown);
+  TEST_ASSERT_EQUAL(2, calls);
+}
+
+static void test_commands_uppercase() {
+  SerialCommands<48, true> upper;
+  resetCommands(upper);
+  Serial.feed("vent on\n");
+  upper.loop(0);
+  TEST_ASSERT_EQUAL_STRING("VENT ON", lastCmd);
+
+  SerialCommands<> exact;
+  resetCommands(exact);
+  Serial.feed("vent on\n");
+  exact.loop(0);
+  TEST_ASSERT_EQUAL(0, calls);
+  TEST_ASSERT_EQUAL_STRING("vent on", lastUnknown);
+}
+
+static void test_commands_unknown() {
+  SerialCommands<> c;
+  resetCommands(c);
+  TEST_ASSERT_FALSE(c.dispatch("RIEGO"));
+  TEST_ASSERT_EQUAL_STRING("RIEGO", lastUnknown);
+  // Linea vacia: no es un comando desconocido
+  memset(lastUnknown, 0, sizeof(lastUnknown));
+  TEST_ASSERT_TRUE(c.dispatch(""));
+  TEST_ASSERT_EQUAL_STRING("", lastUnknown);
+  TEST_ASSERT_EQUAL(0, calls);
+}
+
+static void test_commands_line_endings() {
+  SerialCommands<> c;
+  resetCommands(c);
+
+  // CRLF: la linea vacia que deja el '\n' no hace nada
+  Serial.feed("STATUS\r\n");
+  c.loop(0);
+  TEST_ASSERT_EQUAL(1, calls);
+  TEST_ASSERT_EQUAL_STRING("", lastUnknown);
+
+  Serial.feed("TEMP 20\r");
+  c.loop(0);
+  TEST_ASSERT_EQUAL(2, calls);
+  TEST_ASSERT_EQUAL_STRING("20", lastArgs);
+
+  // Sin fin de linea: se ejecuta tras IDLE_MS sin caracteres
+  Serial.feed("TEMP 30");
+  c.loop(1000);
+  c.loop(1000 + c.IDLE_MS - 1);
+  TEST_ASSERT_EQUAL(2, calls);
+  c.loop(1000 + c.IDLE_MS);
+  TEST_ASSERT_EQUAL(3, calls);
+  TEST_ASSERT_EQUAL_STRING("30", lastArgs);
+}
+
+static void test_commands_overflow() {
+  SerialCommands<8> c;
+  resetCommands(c);
+
+  // "TEMP 25.5" no entra en 7 caracteres: no se ejecuta cortado
+  Serial.feed("TEMP 25.5\n");
+  c.loop(0);
+  TEST_ASSERT_EQUAL(0, calls);
+  TEST_ASSERT_EQUAL_STRING("TEMP 25", lastUnknown);
+
+  // La linea siguiente se arma de cero
+  Serial.feed("STATUS\n");
+  c.loop(0);
+  TEST_ASSERT_EQUAL_STRING("STATUS", lastCmd);
+  TEST_ASSERT_EQUAL(1, calls);
+}
+
+// --------------------- BlinkOutput ---------------------
+static void test_blink_timing() {
+  BlinkOutput<5, 500> led;
+  led.begin();
+  TEST_ASSERT_EQUAL(OUTPUT, pinModeOf[5]);
+
+  // Inactiva no toca el pin
+  led.loop(1000);
+  TEST_ASSERT_EQUAL(LOW, pinLevel[5]);
+
+  led.set(true);
+  led.loop(1000);
+  TEST_ASSERT_EQUAL(HIGH, pinLevel[5]);
+  led.loop(1499);
+  TEST_ASSERT_EQUAL(HIGH, pinLevel[5]);
+  led.loop(1500);
+  TEST_ASSERT_EQUAL(LOW, pinLevel[5]);
+  led.loop(2000);
+  TEST_ASSERT_EQUAL(HIGH, pinLevel[5]);
+
+  // Al apagarla queda en LOW y no vuelve a parpadear
+  led.set(false);
+  TEST_ASSERT_EQUAL(LOW, pinLevel[5]);
+  led.loop(5000);
+  TEST_ASSERT_EQUAL(LOW, pinLevel[5]);
+  TEST_ASSERT_FALSE(led.get());
+}
+
+// --------------------- AnalogPot ---------------------
+static void test_pot_to_range() {
+  TEST_ASSERT_EQUAL(1000, AnalogPot<34>::toRange(0, 1000, 5000));
+  TEST_ASSERT_EQUAL(5000, AnalogPot<34>::toRange(4095, 1000, 5000));
+  TEST_ASSERT_EQUAL(4000, AnalogPot<34>::toRange(0, 4000, 6000));
+  TEST_ASSERT_EQUAL(6000, AnalogPot<34>::toRange(4095, 4000, 6000));
+  TEST_ASSERT_EQUAL(0, AnalogPot<34>::toMillivolts(0));
+  TEST_ASSERT_EQUAL(3300, AnalogPot<34>::toMillivolts(4095));
+
+  AnalogPot<34> pot;
+  analogValue[34] = 4095;
+  TEST_ASSERT_EQUAL(4095, pot.raw());
+  TEST_ASSERT_EQUAL(3300, pot.millivolts());
+}
+
+// --------------------- GreenhouseCore con politicas No* ---------------------
+struct FakeSensor {
+  bool ok = true;
+  centi_t t = 2150;
+  centi_t h = 6040;
+
+  void begin() {}
+  bool read(centi_t& outT, centi_t& outH) {
+    if (!ok) return false;
+    outT = t;
+    outH = h;
+    return true;
+  }
+};
+
+static void test_core_minimal() {
+  TEST_ASSERT_TRUE(std::is_empty<NoPot>::value);
+  TEST_ASSERT_TRUE(std::is_empty<NoDisplay>::value);
+  TEST_ASSERT_TRUE(std::is_empty<NoActuators>::value);
+  TEST_ASSERT_TRUE(std::is_empty<NoCommands>::value);
+
+  GreenhouseCore<FakeSensor> core;
+  TEST_ASSERT_TRUE(core.begin());
+  core.loop(0);
+  TEST_ASSERT_EQUAL(0, core.pot.raw());
+  TEST_ASSERT_EQUAL(CENTI_NAN, core.temp);
+
+  centi_t t, h;
+  TEST_ASSERT_TRUE(core.readSensor(t, h));
+  TEST_ASSERT_EQUAL(2150, core.temp);
+  TEST_ASSERT_EQUAL(6040, core.hum);
+
+  // Una lectura fallida conserva la ultima valida
+  core.sensor.ok = false;
+  TEST_ASSERT_FALSE(core.readSensor(t, h));
+  TEST_ASSERT_EQUAL(2150, core.temp);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_centi_to_str);
+  RUN_TEST(test_centi_to_str_rounding);
+  RUN_TEST(test_centi_to_str_negative);
+  RUN_TEST(test_parse_centi);
+  RUN_TEST(test_parse_centi_rejects);
+  RUN_TEST(test_commands_exact_and_prefix);
+  RUN_TEST(test_commands_uppercase);
+  RUN_TEST(test_commands_unknown);
+  RUN_TEST(test_commands_line_endings);
+  RUN_TEST(test_commands_overflow);
+  RUN_TEST(test_blink_timing);
+  RUN_TEST(test_pot_to_range);
+  RUN_TEST(test_core_minimal);
+  return UNITY_END();
+}
@@ -0,0 +1,117 @@
+/* AlertEngine: alertas por umbral suscriptas desde Telegram
+   - Reglas "temp>30", "hum<40 for 5m" (for = tiempo sostenido: s, m, h)
+   - Tabla compacta ordenada por (sensor, operador, umbral): con cada muestra
+     solo se evaluan las reglas cuyo umbral quedo entre el valor anterior y el
+     nuevo (+ histeresis), asi el costo no crece con la cantidad de reglas
+   - Histeresis para volver a normal; las reglas con "for" esperan el tiempo
+     sostenido antes de disparar
+   - Los avisos se encolan y flush() manda un mensaje por chat con todos los
+     suyos, con un maximo de mensajes por llamada
+   - Si la cola se llena la regla queda marcada con el aviso pendiente y un
+     flush() posterior lo encola con el estado de ese momento; si la regla
+     vuelve al estado anterior antes de avisar, el aviso se cancela
+   Valores en centesimas, tiempos en segundos.
+*/
+#pragma once
+
+#include <Arduino.h>
+
+#include "fixed_point.h"
+
+class AlertEngine {
+public:
+  enum {
+    MAX_RULES = 256,
+    MAX_PER_CHAT = 16,
+    EVENT_QUEUE = 32,
+    MAX_MESSAGES_PER_FLUSH = 4
+  };
+
+  enum Sensor { ALERT_TEMP = 0, ALERT_HUM };
+  enum Op { ALERT_ABOVE = 0, ALERT_BELOW };
+
+  struct Spec {
+    uint8_t sensor;
+    uint8_t op;
+    centi_t threshold;
+    uint32_t holdS;
+  };
+
+  struct Stats {
+    uint32_t samples;
+    uint32_t evaluated;      // reglas evaluadas en total
+    uint32_t fired;
+    uint32_t cleared;
+    uint32_t messages;       // mensajes enviados
+    uint32_t deferred;       // avisos demorados por cola llena
+    uint32_t dropped;        // avisos perdidos (error de envio)
+  };
+
+  // Devuelve false para contar el aviso como perdido
+  typedef bool (*SendFn)(const char* chatId, const String& text, void* ctx);
+
+  AlertEngine();
+
+  // "temp>30", "hum < 40.5 for 5m" -> Spec
+  static bool parse(const char* text, Spec& out);
+  static String specText(const Spec& spec);
+
+  // id de la regla (>0), -1 si la tabla esta llena, -2 si el chat llego al maximo
+  int add(int64_t chat, const Spec& spec, uint32_t now);
+  bool remove(int64_t chat, uint16_t id);
+  int removeAll(int64_t chat);
+  String list(int64_t chat) const;
+
+  void sample(uint32_t now, centi_t temp, centi_t hum);
+  // Dispara las reglas con "for" cuyo tiempo se cumplio
+  void tick(uint32_t now);
+  void flush(SendFn send, void* ctx);
+
+  const Stats& getStats() const { return stats; }
+  String statsText() const;
+
+private:
+  enum State { RULE_IDLE = 0, RULE_PENDING, RULE_FIRING };
+  enum { SEGMENTS = 4 };     // sensor * 2 + op
+
+  struct Rule {
+    int64_t chat;
+    uint32_t holdS;
+    uint32_t since;
+    centi_t threshold;
+    uint16_t id;
+    uint8_t segment;
+    uint8_t state;
+    uint8_t notice;          // aviso pendiente por cola llena (entra en el relleno)
+  };
+
+  struct Event {
+    int64_t chat;
+    centi_t threshold;
+    centi_t value;
+    uint32_t holdS;
+    uint16_t id;
+    uint8_t segment;
+    uint8_t fired;
+  };
+
+  static Spec ruleSpec(const Rule& r);
+  int lowerBound(uint8_t seg, int32_t threshold) const;
+  void evaluate(Rule& r, centi_t v, uint32_t now);
+  void evaluateRange(uint8_t seg, int32_t lo, int32_t hi, centi_t v, uint32_t now);
+  void fire(Rule& r, centi_t v);
+  void queue(Rule& r, centi_t v, bool fired);
+  void requeuePending();
+
+  Rule rules[MAX_RULES];
+  uint16_t segStart[SEGMENTS + 1]; // reglas del segmento s: [segStart[s], segStart[s+1])
+  uint16_t nextId;
+  centi_t lastValue[2];
+  uint32_t nextDeadline;           // proximo vencimiento de una regla pendiente
+
+  Event events[EVENT_QUEUE];
+  uint8_t eventCount;
+  uint16_t pendingNotices;         // cota superior de reglas con notice
+
+  Stats stats;
+};
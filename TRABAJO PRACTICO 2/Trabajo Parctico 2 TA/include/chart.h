@@ -0,0 +1,74 @@
+/* Grafico de temperatura / humedad como PNG monocromo generado en streaming
+   - ChartImage: por cada columna guarda el rango vertical de cada serie
+     (4 bytes/columna) y dibuja una fila a la vez
+   - PngRowStream: arma el PNG (deflate "stored", sin compresion) fila por fila
+     en un buffer chico; el tamaño total se conoce de antemano para el multipart
+   No depende de Arduino: se puede compilar en el host.
+*/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+static const uint8_t CHART_NO_DATA = 0xFF;
+
+struct ChartColumn {
+  uint8_t tTop, tBot;   // temperatura: filas dentro del panel (0 = arriba)
+  uint8_t hTop, hBot;   // humedad
+};
+
+class ChartImage {
+public:
+  enum {
+    WIDTH = 320,
+    HEIGHT = 200,
+    MARGIN = 6,
+    PANEL_H = (HEIGHT - 3 * MARGIN) / 2,
+    ROW_BYTES = WIDTH / 8
+  };
+
+  void clear();
+  // y ya escalados a [0, PANEL_H); x en [0, WIDTH)
+  void addPoint(int x, uint8_t tY, uint8_t hY);
+  // Une columnas consecutivas para que la serie se vea continua
+  void connect();
+  // 1 bit por pixel, MSB = pixel izquierdo, 1 = blanco
+  void renderRow(int y, uint8_t* row) const;
+
+private:
+  ChartColumn cols[WIDTH];
+};
+
+class PngRowStream {
+public:
+  typedef void (*RowFn)(int y, uint8_t* row, void* ctx);
+
+  PngRowStream(uint16_t width, uint16_t height, RowFn fn, void* ctx);
+
+  // Tamaño total del archivo PNG
+  uint32_t size() const;
+  // Prepara el siguiente tramo; false al terminar
+  bool advance();
+  uint8_t* data() { return buf; }
+  size_t length() const { return len; }
+
+private:
+  enum { BUF_BYTES = ChartImage::ROW_BYTES + 16 > 48 ? ChartImage::ROW_BYTES + 16 : 48 };
+
+  void put8(uint8_t v);
+  void put32(uint32_t v);
+  void putData(const uint8_t* p, size_t n, bool idat);
+
+  uint16_t width;
+  uint16_t height;
+  uint16_t rowBytes;
+  RowFn fn;
+  void* ctx;
+
+  int stage;
+  int row;
+  uint32_t crc;
+  uint32_t adlerA, adlerB;
+  uint8_t buf[BUF_BYTES];
+  size_t len;
+};
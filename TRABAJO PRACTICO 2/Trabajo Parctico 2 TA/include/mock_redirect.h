@@ -0,0 +1,28 @@
+/* MockRedirect: redirige las conexiones de un cliente a los servidores simulados
+   (tools/mock_servers.py). Solo se usa en el entorno esp32dev_mock:
+     -DMOCK_API_HOST="ip-de-la-pc" -DMOCK_TELEGRAM_PORT=8443 -DMOCK_THINGSPEAK_PORT=8080
+   UniversalTelegramBot y ThingSpeak siguen pidiendo sus hosts reales; aca se
+   reemplaza host y puerto antes de abrir el socket.
+*/
+#pragma once
+
+#include <Arduino.h>
+
+template <class Base>
+class MockRedirect : public Base {
+public:
+  // Los argumentos extra van al constructor de Base
+  template <typename... Args>
+  MockRedirect(const char* host, uint16_t port, Args... args)
+    : Base(args...), mockHost(host), mockPort(port) {}
+
+  int connect(const char* host, uint16_t port) override {
+    (void)host;
+    (void)port;
+    return Base::connect(mockHost, mockPort);
+  }
+
+private:
+  const char* mockHost;
+  uint16_t mockPort;
+};
@@ -0,0 +1,80 @@
+/* NetPerf: latencias de red por endpoint y por fase
+   - Fases: DNS, conexion TCP, TLS, envio del request, primer byte, cuerpo, total
+   - Un histograma de tamaño fijo por fase (buckets logaritmicos en ms)
+   - Muestras de heap libre y bloque maximo al terminar cada request
+   Los datos los carga TimedClient (timed_client.h); tambien se pueden
+   registrar operaciones locales (ej. lectura del DHT) con la fase total.
+*/
+#pragma once
+
+#include <Arduino.h>
+
+enum NetPhase {
+  PHASE_DNS = 0,
+  PHASE_CONNECT,    // TCP (solo clientes sin TLS)
+  PHASE_TLS,        // TCP + handshake (clientes TLS: la libreria no los separa)
+  PHASE_REQUEST,    // escritura del request
+  PHASE_FIRST_BYTE, // fin del request -> primer byte de respuesta
+  PHASE_BODY,       // primer byte -> ultimo byte leido
+  PHASE_TOTAL,
+  PHASE_COUNT
+};
+
+class LatencyHistogram {
+public:
+  enum { BUCKETS = 32 };
+
+  void add(uint32_t ms);
+  // Cota superior del bucket que contiene el percentil (acotada al maximo)
+  uint32_t percentile(uint8_t p) const;
+  uint32_t count() const { return n; }
+  uint32_t max() const { return maxMs; }
+
+private:
+  uint16_t buckets[BUCKETS];
+  uint32_t n;
+  uint32_t maxMs;
+};
+
+class NetPerf {
+public:
+  enum {
+    MAX_ENDPOINTS = 6,
+    NAME_LEN = 16
+  };
+
+  // Busca o crea el endpoint; -1 si la tabla esta llena
+  int endpoint(const char* name);
+  void record(int ep, NetPhase phase, uint32_t ms);
+  void sampleHeap(int ep);
+
+  String report() const;
+  void dump(Print& out) const;
+
+private:
+  struct Endpoint {
+    char name[NAME_LEN];
+    LatencyHistogram phases[PHASE_COUNT];
+    uint32_t heapSamples;
+    uint32_t minFreeHeap;
+    uint32_t minMaxBlock;
+    uint32_t lastFreeHeap;
+    uint32_t lastMaxBlock;
+  };
+
+  Endpoint endpoints[MAX_ENDPOINTS];
+  int used = 0;
+};
+
+extern NetPerf netPerf;
+
+// Mide una operacion local (ej. lectura del DHT) en la fase total
+class ScopedTimer {
+public:
+  explicit ScopedTimer(const char* name) : ep(netPerf.endpoint(name)), t0(micros()) {}
+  ~ScopedTimer() { netPerf.record(ep, PHASE_TOTAL, (micros() - t0) / 1000); }
+
+private:
+  int ep;
+  uint32_t t0;
+};
@@ -0,0 +1,59 @@
+/* OledService: tarea dueña del SSD1306
+   - show() copia la descripcion de la pantalla (titulo + linea grande) en el
+     buffer de atras y vuelve enseguida; no toca el I2C
+   - La tarea intercambia buffers y dibuja/envia a lo sumo una vez por
+     MIN_FRAME_MS; si llegan varias pantallas en ese tiempo solo se dibuja
+     la ultima (las intermedias se cuentan como descartadas)
+   El display lo inicia el nucleo (Ssd1306Display en lib/greenhouse_core),
+   que tambien fija el reloj del I2C.
+*/
+#pragma once
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+
+class OledService {
+public:
+  enum {
+    TITLE_LEN = 22,      // 21 caracteres a tamaño 1
+    BODY_LEN = 48,
+    MIN_FRAME_MS = 50    // maximo 20 cuadros por segundo
+  };
+
+  struct Stats {
+    uint32_t submitted;  // pantallas pedidas
+    uint32_t dropped;    // reemplazadas antes de dibujarse
+    uint32_t frames;     // enviadas al display
+    uint32_t lastFlushUs;
+    uint32_t maxFlushUs;
+  };
+
+  explicit OledService(Adafruit_SSD1306& display);
+
+  // Arranca la tarea (el display ya iniciado)
+  void begin();
+  void show(const String& title, const String& body);
+
+  const Stats& getStats() const { return stats; }
+  String statsText() const;
+
+private:
+  struct Screen {
+    char title[TITLE_LEN];
+    char body[BODY_LEN];
+  };
+
+  static void taskEntry(void* arg);
+  void run();
+  void render(const Screen& s);
+
+  Adafruit_SSD1306& display;
+  TaskHandle_t task;
+  portMUX_TYPE lock;
+
+  Screen back;           // escrito por show()
+  Screen front;          // lo dibuja la tarea
+  volatile bool pending;
+
+  Stats stats;
+};
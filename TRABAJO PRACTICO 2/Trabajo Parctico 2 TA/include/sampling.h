@@ -0,0 +1,83 @@
+/* Muestreo adaptativo del DHT22 y publicacion por banda muerta
+   - AdaptiveSampler: intervalo minimo (2 s, limite del DHT22) cuando la
+     temperatura o la humedad cambian rapido; se alarga x1.5 por muestra
+     estable hasta el maximo
+   - DeadbandPublisher: deja pasar una muestra solo si se movio mas que la
+     banda muerta respecto de la ultima publicada, o si vencio el silencio
+     maximo
+   Ambos cuentan muestras tomadas vs publicadas. Valores en centesimas.
+*/
+#pragma once
+
+#include <Arduino.h>
+
+#include "fixed_point.h"
+
+class AdaptiveSampler {
+public:
+  struct Config {
+    uint32_t minIntervalMs;
+    uint32_t maxIntervalMs;
+    centi_t fastTempPerMin;  // cambio por minuto que vuelve al intervalo minimo
+    centi_t fastHumPerMin;
+    centi_t quietTemp;       // cambio entre muestras considerado estable
+    centi_t quietHum;        // (por debajo no acelera aunque dt sea corto)
+  };
+
+  struct Stats {
+    uint32_t samples;        // lecturas validas
+    uint32_t errors;         // lecturas fallidas
+    uint32_t speedUps;       // vueltas al intervalo minimo
+    uint32_t backOffs;       // alargues del intervalo
+  };
+
+  explicit AdaptiveSampler(const Config& cfg);
+
+  bool due(unsigned long now) const { return now - lastSample >= interval; }
+  // Registrar una lectura valida / fallida tomada en 'now'
+  void update(unsigned long now, centi_t temp, centi_t hum);
+  void error(unsigned long now);
+
+  uint32_t intervalMs() const { return interval; }
+  const Stats& getStats() const { return stats; }
+
+private:
+  Config cfg;
+  uint32_t interval;
+  unsigned long lastSample;
+  bool hasLast;
+  centi_t lastTemp, lastHum;
+  Stats stats;
+};
+
+class DeadbandPublisher {
+public:
+  // Motivo de una publicacion; SKIP (= 0) es "no publicar"
+  enum Reason { SKIP = 0, FIRST, CHANGE, SILENCE, MANUAL };
+
+  struct Stats {
+    uint32_t offered;        // muestras recibidas
+    uint32_t published;      // muestras publicadas
+    uint32_t bySilence;      // de ellas, por silencio maximo
+  };
+
+  DeadbandPublisher(centi_t tempBand, centi_t humBand, uint32_t maxSilenceMs);
+
+  // Distinto de SKIP si la muestra hay que publicarla. Si el envio sale bien
+  // llamar a published() con ese motivo; si no, la proxima muestra vuelve a
+  // intentarlo. Un envio por fuera de offer() (/platiot) usa MANUAL.
+  Reason offer(unsigned long now, centi_t temp, centi_t hum);
+  void published(unsigned long now, centi_t temp, centi_t hum, Reason reason);
+
+  const Stats& getStats() const { return stats; }
+
+private:
+  centi_t tempBand, humBand;
+  uint32_t maxSilenceMs;
+  bool hasLast;
+  unsigned long lastPublish;
+  centi_t lastTemp, lastHum;
+  Stats stats;
+};
+
+String samplingStatsText(const AdaptiveSampler& sampler, const DeadbandPublisher& publisher);
@@ -0,0 +1,163 @@
+/* TimedClient: mide cada request HTTP que pasa por un cliente y lo carga en NetPerf
+   - connect(): mide el DNS como fase propia y despues conecta por el camino
+     normal de Base::connect(host, port) (certificados, PSK y bundle del
+     cliente intactos); la resolucion interna de Base sale de la cache de
+     DNS de lwIP que acaba de llenarse, sin otra consulta a la red
+   - write / available / read: detecta envio, espera del primer byte y cuerpo
+   - El endpoint sale de la linea del request: "<prefijo>:<ultimo tramo del path>"
+     ej. "tg:getUpdates", "tg:sendMessage", "ts:update"
+   Un request se cierra cuando empieza el siguiente, en stop() o en connect().
+   Con conexiones keep-alive (UniversalTelegramBot) las fases de DNS y conexion
+   solo aparecen en los requests que abren conexion.
+*/
+#pragma once
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+
+#include "net_perf.h"
+
+template <class Base>
+class TimedClient : public Base {
+public:
+  using Base::connect;
+  using Base::write;
+  using Base::read;
+
+  template <typename... Args>
+  TimedClient(const char* prefix, bool tls, Args... args)
+    : Base(args...), prefix(prefix), tls(tls) {}
+
+  int connect(const char* host, uint16_t port) override {
+    finish();
+    uint32_t t0 = micros();
+    IPAddress ip;
+    if (!WiFi.hostByName(host, ip)) return 0;
+    uint32_t t1 = micros();
+    int r = Base::connect(host, port);
+    uint32_t t2 = micros();
+    dnsUs = t1 - t0;
+    connectUs = t2 - t1;
+    newConnection = true;
+    return r;
+  }
+
+  size_t write(uint8_t c) override {
+    onWrite(&c, 1);
+    return Base::write(c);
+  }
+
+  size_t write(const uint8_t* buf, size_t size) override {
+    onWrite(buf, size);
+    return Base::write(buf, size);
+  }
+
+  int available() override {
+    int a = Base::available();
+    onPoll(a > 0);
+    return a;
+  }
+
+  int read() override {
+    int c = Base::read();
+    onPoll(c >= 0);
+    return c;
+  }
+
+  int read(uint8_t* buf, size_t size) override {
+    int r = Base::read(buf, size);
+    onPoll(r > 0);
+    return r;
+  }
+
+  void stop() override {
+    finish();
+    Base::stop();
+  }
+
+private:
+  enum State { IDLE, WRITING, WAITING, READING };
+
+  void onWrite(const uint8_t* p, size_t n) {
+    if (state != IDLE && state != WRITING) finish();
+    if (state == IDLE) {
+      state = WRITING;
+      tStart = micros();
+      method[0] = '\0';
+      methodLen = 0;
+      lineState = 0;
+    }
+    parseRequestLine(p, n);
+  }
+
+  void onPoll(bool hasData) {
+    uint32_t now = micros();
+    if (state == WRITING) {
+      tWriteEnd = now;
+      state = WAITING;
+    }
+    if (!hasData) return;
+    if (state == WAITING) {
+      tFirst = now;
+      tLast = now;
+      state = READING;
+    } else if (state == READING) {
+      tLast = now;
+    }
+  }
+
+  // "GET /bot<token>/getUpdates?offset=.. HTTP/1.1": se guarda solo el ultimo
+  // tramo del path, sin copiar el token
+  void parseRequestLine(const uint8_t* p, size_t n) {
+    for (size_t i = 0; i < n && lineState < 3; i++) {
+      char c = (char)p[i];
+      if (lineState == 0) {          // metodo HTTP
+        if (c == ' ') lineState = 1;
+      } else if (c == '?' || c == ' ' || c == '\r' || c == '\n') {
+        lineState = 3;               // fin del path
+      } else if (c == '/') {
+        lineState = 2;
+        methodLen = 0;
+      } else if (lineState == 2 && methodLen < sizeof(method) - 1) {
+        method[methodLen++] = c;
+      }
+      method[methodLen] = '\0';
+    }
+  }
+
+  void finish() {
+    if (state == IDLE) return;
+    if (state == WRITING) tWriteEnd = micros();
+    if (state != READING) tFirst = tLast = tWriteEnd;
+
+    char name[NetPerf::NAME_LEN];
+    snprintf(name, sizeof(name), "%s:%s", prefix, methodLen ? method : "?");
+    int ep = netPerf.endpoint(name);
+
+    uint32_t total = (tWriteEnd - tStart) + (tFirst - tWriteEnd) + (tLast - tFirst);
+    if (newConnection) {
+      netPerf.record(ep, PHASE_DNS, dnsUs / 1000);
+      netPerf.record(ep, tls ? PHASE_TLS : PHASE_CONNECT, connectUs / 1000);
+      total += dnsUs + connectUs;
+      newConnection = false;
+    }
+    netPerf.record(ep, PHASE_REQUEST, (tWriteEnd - tStart) / 1000);
+    netPerf.record(ep, PHASE_FIRST_BYTE, (tFirst - tWriteEnd) / 1000);
+    netPerf.record(ep, PHASE_BODY, (tLast - tFirst) / 1000);
+    netPerf.record(ep, PHASE_TOTAL, total / 1000);
+    netPerf.sampleHeap(ep);
+    state = IDLE;
+  }
+
+  const char* prefix;
+  bool tls;
+
+  State state = IDLE;
+  bool newConnection = false;
+  uint32_t dnsUs = 0, connectUs = 0;
+  uint32_t tStart = 0, tWriteEnd = 0, tFirst = 0, tLast = 0;
+  uint8_t lineState = 0;
+  char method[14];
+  uint8_t methodLen = 0;
+};
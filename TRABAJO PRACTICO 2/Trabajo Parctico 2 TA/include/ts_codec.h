@@ -0,0 +1,88 @@
+/* Codec de series temporales (estilo Gorilla)
+   - Tiempo: delta-of-delta con prefijos de largo variable
+   - Temperatura / humedad: XOR contra el valor anterior (centesimas, 32 bits)
+   - Bloques de tamaño fijo, sin memoria dinamica
+   No depende de Arduino: se puede compilar en el host.
+*/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fixed_point.h"
+
+struct TsSample {
+  uint32_t t;      // segundos
+  centi_t temp;
+  centi_t hum;
+};
+
+// La misma muestra con temp / hum en float, como se guardaba antes del punto
+// fijo: base de comparacion de la compresion con mediciones anteriores
+struct TsFloatSample {
+  uint32_t t;
+  float temp;
+  float hum;
+};
+
+// Peor caso por muestra: 4+32 bits de tiempo + 2 x (2+5+5+32) de valores
+static const uint32_t TS_MAX_SAMPLE_BITS = 36 + 2 * 44;
+
+class TsBlockEncoder {
+public:
+  void reset(uint8_t* buf, size_t size);
+  // false si la muestra no entra: hay que cerrar el bloque
+  bool append(const TsSample& s);
+
+  uint16_t count() const { return n; }
+  uint32_t bitsUsed() const { return bitPos; }
+  uint32_t firstTime() const { return t0; }
+  uint32_t lastTime() const { return prevT; }
+
+private:
+  struct ValueState {
+    uint32_t prev;
+    uint8_t lead;
+    uint8_t trail;
+  };
+
+  void writeBits(uint32_t v, uint8_t bits);
+  void encodeValue(centi_t v, ValueState& st);
+
+  uint8_t* buf;
+  uint32_t capBits;
+  uint32_t bitPos;
+  uint16_t n;
+  uint32_t t0;
+  uint32_t prevT;
+  int32_t prevDelta;
+  ValueState temp;
+  ValueState hum;
+};
+
+// Decodificacion en streaming: una muestra por llamada, sin buffers extra
+class TsBlockDecoder {
+public:
+  TsBlockDecoder(const uint8_t* buf, uint32_t bits, uint16_t count);
+  bool next(TsSample& out);
+
+private:
+  struct ValueState {
+    uint32_t prev;
+    uint8_t lead;
+    uint8_t trail;
+  };
+
+  uint32_t readBits(uint8_t bits);
+  centi_t decodeValue(ValueState& st);
+
+  const uint8_t* buf;
+  uint32_t capBits;
+  uint32_t bitPos;
+  uint16_t total;
+  uint16_t n;
+  uint32_t prevT;
+  int32_t prevDelta;
+  ValueState temp;
+  ValueState hum;
+};
@@ -0,0 +1,71 @@
+/* TsStore: historial comprimido de temperatura / humedad
+   - Un bloque activo en RAM (TsBlockEncoder)
+   - Al llenarse se guarda en LittleFS como registro de tamaño fijo
+   - El archivo es un buffer circular de MAX_FILE_BLOCKS bloques
+   - Consultas por rango decodificando en streaming
+   El bloque activo se pierde en un reset (a lo sumo BLOCK_BYTES de historial).
+*/
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include "ts_codec.h"
+
+class TsStore {
+public:
+  enum {
+    BLOCK_BYTES = 512,
+    MAX_FILE_BLOCKS = 64
+  };
+
+  // Devuelve false para cortar la consulta
+  typedef bool (*SampleCallback)(const TsSample& s, void* ctx);
+
+  struct Stats {
+    uint32_t samples;        // muestras agregadas desde el arranque
+    uint32_t blocksFlushed;
+    uint32_t flushErrors;
+    uint64_t compressedBits; // bits de las muestras agregadas
+    uint64_t encodeCycles;   // solo codificacion, sin la escritura a flash
+    uint64_t flushCycles;    // escrituras de bloques a LittleFS
+  };
+
+  TsStore();
+
+  bool begin();
+  void append(uint32_t t, centi_t temp, centi_t hum);
+  // Guarda el bloque activo aunque no este lleno
+  void flush();
+  // Recorre muestras con from <= t <= to, de la mas vieja a la mas nueva
+  uint32_t query(uint32_t from, uint32_t to, SampleCallback cb, void* ctx);
+
+  // Ultimo tiempo guardado (0 si no hay historial)
+  uint32_t lastTime() const { return lastT; }
+  const Stats& getStats() const { return stats; }
+  // Relacion de compresion x10 (37 = 3.7x) contra rawBytes por muestra sin
+  // comprimir: sizeof(TsSample) o sizeof(TsFloatSample)
+  uint32_t compressionRatio10(size_t rawBytes = sizeof(TsSample)) const;
+  String statsText() const;
+
+private:
+  struct BlockHeader {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t t0;
+    uint32_t tLast;
+    uint16_t count;
+    uint16_t bits;
+  };
+
+  bool writeBlock();
+  void startBlock();
+  bool readHeader(File& f, uint32_t slot, BlockHeader& h);
+
+  bool fsOk;
+  uint32_t nextSeq;
+  uint32_t lastT;
+  TsBlockEncoder enc;
+  uint8_t active[BLOCK_BYTES];
+  uint8_t scratch[BLOCK_BYTES];
+  Stats stats;
+};
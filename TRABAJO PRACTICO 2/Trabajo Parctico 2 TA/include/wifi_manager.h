@@ -0,0 +1,93 @@
+/* WifiManager: conexion WiFi no bloqueante
+   - Guarda BSSID y canal en memoria RTC para reconectar rapido; la IP sale
+     siempre de la configuracion actual (estatica o DHCP), nunca del cache
+   - Asociacion + DHCP manejados por eventos, loop() nunca bloquea
+   - Reconexion con backoff exponencial
+   - Estadisticas: tiempo de conexion y cortes
+*/
+#pragma once
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+class WifiManager {
+public:
+  enum State {
+    WIFI_IDLE = 0,
+    WIFI_CONNECTING,
+    WIFI_CONNECTED,
+    WIFI_BACKOFF
+  };
+
+  struct Stats {
+    uint32_t connects;         // conexiones exitosas
+    uint32_t fastConnects;     // de ellas, usando BSSID/canal cacheados
+    uint32_t attempts;         // intentos totales
+    uint32_t lastConnectMs;    // tiempo del ultimo intento exitoso
+    uint32_t minConnectMs;
+    uint32_t maxConnectMs;
+    uint32_t outages;          // desconexiones luego de estar conectado
+    uint32_t lastOutageMs;
+    uint32_t longestOutageMs;
+    uint32_t totalOutageMs;
+  };
+
+  WifiManager();
+
+  void begin(const char* ssid, const char* pass);
+  // IP estatica opcional: evita DHCP. Llamar antes de begin().
+  void setStaticIP(IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns);
+  void loop();
+
+  bool isConnected() const { return state == WIFI_CONNECTED; }
+  // true una sola vez luego de cada conexion exitosa
+  bool justConnected();
+  State getState() const { return state; }
+  const Stats& getStats() const { return stats; }
+  unsigned long currentOutageMs() const;
+
+  void printStats(Print& out) const;
+  String statsText() const;
+
+private:
+  // Cache en RTC (sobrevive a reset por software y deep sleep)
+  // ssidHash: el cache solo vale para la red con la que se guardo
+  struct RtcCache {
+    uint32_t magic;
+    uint32_t ssidHash;
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint32_t checksum;
+  };
+  static RtcCache rtcCache;
+
+  static uint32_t fnv1a(const uint8_t* p, size_t n, uint32_t h = 2166136261u);
+  static uint32_t cacheChecksum(const RtcCache& c);
+  static uint32_t hashSsid(const char* ssid);
+  bool cacheValid() const;
+  static void cacheInvalidate();
+  void cacheStore();
+
+  void startAttempt();
+  void onEvent(arduino_event_id_t event);
+
+  const char* ssid;
+  const char* pass;
+  bool useStaticIp;
+  IPAddress staticIp, staticGw, staticMask, staticDns;
+
+  State state;
+  bool attemptIsFast;
+  bool connectedFlag;
+  unsigned long attemptStart;
+  unsigned long backoffMs;
+  unsigned long backoffUntil;
+  unsigned long outageStart;
+  bool everConnected;
+
+  // Escritos desde la tarea de eventos de WiFi
+  volatile bool evGotIp;
+  volatile bool evDisconnected;
+
+  Stats stats;
+};
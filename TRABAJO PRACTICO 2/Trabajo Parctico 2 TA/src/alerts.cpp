@@ -0,0 +1,353 @@
+#include "alerts.h"
+
+// Histeresis para volver a normal, por sensor (centesimas)
+static const int32_t HYST[2] = { 50, 200 };   // 0.5 C, 2 %
+static const char* SENSOR_NAMES[2] = { "temp", "hum" };
+static const uint32_t MAX_HOLD_S = 24UL * 3600;
+static const uint32_t NO_DEADLINE = UINT32_MAX;
+
+AlertEngine::AlertEngine()
+  : nextId(1), nextDeadline(NO_DEADLINE), eventCount(0), pendingNotices(0) {
+  memset(segStart, 0, sizeof(segStart));
+  lastValue[ALERT_TEMP] = CENTI_NAN;
+  lastValue[ALERT_HUM] = CENTI_NAN;
+  memset(&stats, 0, sizeof(stats));
+}
+
+// --------------------- Parseo ---------------------
+static const char* skipSpaces(const char* s) {
+  while (*s == ' ') s++;
+  return s;
+}
+
+bool AlertEngine::parse(const char* text, Spec& out) {
+  const char* s = skipSpaces(text);
+  if (strncmp(s, "temp", 4) == 0) {
+    out.sensor = ALERT_TEMP;
+    s += 4;
+  } else if (strncmp(s, "hum", 3) == 0) {
+    out.sensor = ALERT_HUM;
+    s += 3;
+  } else {
+    return false;
+  }
+
+  s = skipSpaces(s);
+  if (*s == '>') out.op = ALERT_ABOVE;
+  else if (*s == '<') out.op = ALERT_BELOW;
+  else return false;
+  s++;
+
+  // El numero llega hasta " for" o el final
+  const char* end = strstr(s, " for ");
+  size_t len = end ? (size_t)(end - s) : strlen(s);
+  char num[12];
+  if (len == 0 || len >= sizeof(num)) return false;
+  memcpy(num, s, len);
+  num[len] = '\0';
+  int32_t th;
+  if (!parseCenti(num, th) || th < -10000 || th > 20000) return false;
+  out.threshold = (centi_t)th;
+
+  out.holdS = 0;
+  if (end) {
+    s = skipSpaces(end + 5);
+    uint32_t n = 0;
+    int digits = 0;
+    while (*s >= '0' && *s <= '9' && digits < 6) {
+      n = n * 10 + (*s++ - '0');
+      digits++;
+    }
+    if (digits == 0) return false;
+    if (*s == 's') s++;
+    else if (*s == 'm') { n *= 60; s++; }
+    else if (*s == 'h') { n *= 3600; s++; }
+    else return false;
+    s = skipSpaces(s);
+    if (*s != '\0' || n > MAX_HOLD_S) return false;
+    out.holdS = n;
+  }
+  return true;
+}
+
+String AlertEngine::specText(const Spec& spec) {
+  char th[16], buf[40];
+  centiToStr(th, spec.threshold, 1);
+  int n = snprintf(buf, sizeof(buf), "%s%c%s", SENSOR_NAMES[spec.sensor],
+                   spec.op == ALERT_ABOVE ? '>' : '<', th);
+  if (spec.holdS > 0 && n > 0 && n < (int)sizeof(buf)) {
+    if (spec.holdS % 3600 == 0) snprintf(buf + n, sizeof(buf) - n, " for %luh", (unsigned long)(spec.holdS / 3600));
+    else if (spec.holdS % 60 == 0) snprintf(buf + n, sizeof(buf) - n, " for %lum", (unsigned long)(spec.holdS / 60));
+    else snprintf(buf + n, sizeof(buf) - n, " for %lus", (unsigned long)spec.holdS);
+  }
+  return String(buf);
+}
+
+AlertEngine::Spec AlertEngine::ruleSpec(const Rule& r) {
+  Spec spec;
+  spec.sensor = r.segment >> 1;
+  spec.op = r.segment & 1;
+  spec.threshold = r.threshold;
+  spec.holdS = r.holdS;
+  return spec;
+}
+
+// --------------------- Tabla de reglas ---------------------
+// Primera regla del segmento con umbral >= threshold
+int AlertEngine::lowerBound(uint8_t seg, int32_t threshold) const {
+  int lo = segStart[seg], hi = segStart[seg + 1];
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (rules[mid].threshold < threshold) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+int AlertEngine::add(int64_t chat, const Spec& spec, uint32_t now) {
+  int total = segStart[SEGMENTS];
+  if (total >= MAX_RULES) return -1;
+  int perChat = 0;
+  for (int i = 0; i < total; i++) {
+    if (rules[i].chat == chat) perChat++;
+  }
+  if (perChat >= MAX_PER_CHAT) return -2;
+
+  uint8_t seg = spec.sensor * 2 + spec.op;
+  int pos = lowerBound(seg, spec.threshold);
+  memmove(&rules[pos + 1], &rules[pos], (total - pos) * sizeof(Rule));
+  for (int s = seg + 1; s <= SEGMENTS; s++) segStart[s]++;
+
+  Rule& r = rules[pos];
+  r.chat = chat;
+  r.holdS = spec.holdS;
+  r.since = now;
+  r.threshold = spec.threshold;
+  r.id = nextId++;
+  if (nextId == 0) nextId = 1;
+  r.segment = seg;
+  r.state = RULE_IDLE;
+  r.notice = 0;
+
+  // Se evalua contra el ultimo valor: si ya se cumple avisa sin esperar otra muestra
+  centi_t v = lastValue[spec.sensor];
+  if (centiValid(v)) evaluate(r, v, now);
+  return r.id;
+}
+
+bool AlertEngine::remove(int64_t chat, uint16_t id) {
+  int total = segStart[SEGMENTS];
+  for (int i = 0; i < total; i++) {
+    if (rules[i].id != id || rules[i].chat != chat) continue;
+    uint8_t seg = rules[i].segment;
+    memmove(&rules[i], &rules[i + 1], (total - i - 1) * sizeof(Rule));
+    for (int s = seg + 1; s <= SEGMENTS; s++) segStart[s]--;
+    return true;
+  }
+  return false;
+}
+
+int AlertEngine::removeAll(int64_t chat) {
+  int total = segStart[SEGMENTS];
+  int out = 0, removed = 0;
+  uint16_t newStart[SEGMENTS + 1] = { 0 };
+  for (int i = 0; i < total; i++) {
+    if (rules[i].chat == chat) {
+      removed++;
+      continue;
+    }
+    newStart[rules[i].segment + 1]++;
+    if (out != i) rules[out] = rules[i];
+    out++;
+  }
+  for (int s = 0; s < SEGMENTS; s++) newStart[s + 1] += newStart[s];
+  memcpy(segStart, newStart, sizeof(segStart));
+  return removed;
+}
+
+String AlertEngine::list(int64_t chat) const {
+  String out;
+  int total = segStart[SEGMENTS];
+  for (int i = 0; i < total; i++) {
+    const Rule& r = rules[i];
+    if (r.chat != chat) continue;
+    out += "#" + String(r.id) + " " + specText(ruleSpec(r));
+    if (r.state == RULE_FIRING) out += " (activa)";
+    else if (r.state == RULE_PENDING) out += " (esperando)";
+    out += "\n";
+  }
+  return out;
+}
+
+// --------------------- Evaluacion ---------------------
+void AlertEngine::evaluate(Rule& r, centi_t v, uint32_t now) {
+  stats.evaluated++;
+  int32_t hyst = HYST[r.segment >> 1];
+  bool above = (r.segment & 1) == ALERT_ABOVE;
+  bool cond = above ? v > r.threshold : v < r.threshold;
+  bool normal = above ? v < r.threshold - hyst : v > r.threshold + hyst;
+
+  switch (r.state) {
+    case RULE_IDLE:
+      if (!cond) break;
+      if (r.holdS == 0) {
+        fire(r, v);
+      } else {
+        r.state = RULE_PENDING;
+        r.since = now;
+        if (now + r.holdS < nextDeadline) nextDeadline = now + r.holdS;
+      }
+      break;
+    case RULE_PENDING:
+      if (!cond) r.state = RULE_IDLE;
+      else if (now - r.since >= r.holdS) fire(r, v);
+      break;
+    case RULE_FIRING:
+      if (normal) {
+        r.state = RULE_IDLE;
+        stats.cleared++;
+        queue(r, v, false);
+      }
+      break;
+  }
+}
+
+void AlertEngine::fire(Rule& r, centi_t v) {
+  r.state = RULE_FIRING;
+  stats.fired++;
+  queue(r, v, true);
+}
+
+// Solo cambian de estado las reglas con umbral en [lo, hi]
+void AlertEngine::evaluateRange(uint8_t seg, int32_t lo, int32_t hi, centi_t v, uint32_t now) {
+  int end = segStart[seg + 1];
+  for (int i = lowerBound(seg, lo); i < end && rules[i].threshold <= hi; i++) {
+    evaluate(rules[i], v, now);
+  }
+}
+
+void AlertEngine::sample(uint32_t now, centi_t temp, centi_t hum) {
+  stats.samples++;
+  const centi_t values[2] = { temp, hum };
+  for (int sensor = 0; sensor < 2; sensor++) {
+    centi_t v = values[sensor];
+    if (!centiValid(v)) continue;
+    centi_t prev = lastValue[sensor];
+    lastValue[sensor] = v;
+
+    // Una regla solo cambia de estado si el valor cruzo su umbral o su
+    // umbral +- histeresis; la primera muestra evalua todo
+    int32_t lo = INT16_MIN, hi = INT16_MAX;
+    if (centiValid(prev)) {
+      lo = min((int32_t)prev, (int32_t)v) - HYST[sensor];
+      hi = max((int32_t)prev, (int32_t)v) + HYST[sensor];
+    }
+    evaluateRange(sensor * 2 + ALERT_ABOVE, lo, hi, v, now);
+    evaluateRange(sensor * 2 + ALERT_BELOW, lo, hi, v, now);
+  }
+}
+
+void AlertEngine::tick(uint32_t now) {
+  if (nextDeadline == NO_DEADLINE || (int32_t)(now - nextDeadline) < 0) return;
+
+  // Vencio al menos una regla pendiente: se recorren las pendientes y se
+  // recalcula el proximo vencimiento (pasa una vez por vencimiento, no por muestra)
+  nextDeadline = NO_DEADLINE;
+  int total = segStart[SEGMENTS];
+  for (int i = 0; i < total; i++) {
+    Rule& r = rules[i];
+    if (r.state != RULE_PENDING) continue;
+    if (now - r.since >= r.holdS) fire(r, lastValue[r.segment >> 1]);
+    else if (r.since + r.holdS < nextDeadline) nextDeadline = r.since + r.holdS;
+  }
+}
+
+// --------------------- Avisos ---------------------
+void AlertEngine::queue(Rule& r, centi_t v, bool fired) {
+  // Los avisos de una regla alternan ALERTA / normal: con uno pendiente, el
+  // nuevo lo anula y el chat ya conoce el estado actual
+  if (r.notice) {
+    r.notice = 0;
+    return;
+  }
+  if (eventCount >= EVENT_QUEUE) {
+    r.notice = 1;
+    pendingNotices++;
+    stats.deferred++;
+    return;
+  }
+  Event& e = events[eventCount++];
+  e.chat = r.chat;
+  e.threshold = r.threshold;
+  e.value = v;
+  e.holdS = r.holdS;
+  e.id = r.id;
+  e.segment = r.segment;
+  e.fired = fired ? 1 : 0;
+}
+
+// Encola los avisos pendientes que entren, con el estado y valor actuales
+void AlertEngine::requeuePending() {
+  if (pendingNotices == 0 || eventCount >= EVENT_QUEUE) return;
+  uint16_t left = 0;
+  int total = segStart[SEGMENTS];
+  for (int i = 0; i < total; i++) {
+    Rule& r = rules[i];
+    if (!r.notice) continue;
+    if (eventCount >= EVENT_QUEUE) {
+      left++;
+      continue;
+    }
+    r.notice = 0;
+    queue(r, lastValue[r.segment >> 1], r.state == RULE_FIRING);
+  }
+  pendingNotices = left;
+}
+
+void AlertEngine::flush(SendFn send, void* ctx) {
+  requeuePending();
+  for (int m = 0; m < MAX_MESSAGES_PER_FLUSH && eventCount > 0; m++) {
+    // Junta todos los avisos del chat del primer evento en un mensaje
+    int64_t chat = events[0].chat;
+    String text = "Alertas invernadero\n";
+    int lines = 0;
+    uint8_t out = 0;
+    for (uint8_t i = 0; i < eventCount; i++) {
+      const Event& e = events[i];
+      if (e.chat != chat) {
+        events[out++] = e;
+        continue;
+      }
+      Spec spec;
+      spec.sensor = e.segment >> 1;
+      spec.op = e.segment & 1;
+      spec.threshold = e.threshold;
+      spec.holdS = e.holdS;
+      char v[16];
+      centiToStr(v, e.value, 1);
+      text += "#" + String(e.id) + " " + specText(spec) + (e.fired ? ": ALERTA" : ": normal") + ", ahora " + v + "\n";
+      lines++;
+    }
+    eventCount = out;
+
+    char chatId[24];
+    snprintf(chatId, sizeof(chatId), "%lld", (long long)chat);
+    if (send(chatId, text, ctx)) stats.messages++;
+    else stats.dropped += lines;
+  }
+}
+
+String AlertEngine::statsText() const {
+  char buf[240];
+  snprintf(buf, sizeof(buf),
+           "Reglas: %u/%u\n"
+           "Muestras: %lu, reglas evaluadas: %lu\n"
+           "Disparos: %lu, normalizadas: %lu\n"
+           "Mensajes: %lu, avisos demorados: %lu, perdidos: %lu",
+           (unsigned)segStart[SEGMENTS], (unsigned)MAX_RULES,
+           (unsigned long)stats.samples, (unsigned long)stats.evaluated,
+           (unsigned long)stats.fired, (unsigned long)stats.cleared,
+           (unsigned long)stats.messages, (unsigned long)stats.deferred,
+           (unsigned long)stats.dropped);
+  return String(buf);
+}
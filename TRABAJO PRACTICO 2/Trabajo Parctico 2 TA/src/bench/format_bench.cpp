@@ -0,0 +1,124 @@
+/* Benchmark: camino float vs camino en punto fijo
+   Se compila solo en los entornos bench_format_fixed / bench_format_float
+   (ver platformio.ini). Cada imagen contiene un solo camino, asi el tamaño de
+   flash que informa "pio run" compara directamente lo que arrastra cada uno:
+     pio run -e bench_format_fixed -e bench_format_float
+   Al arrancar imprime los ciclos por actualizacion por Serial.
+
+   Una "actualizacion" es lo que hace el firmware con cada lectura:
+   decodificar, comparar con histeresis y formatear para OLED, Serial y Telegram.
+*/
+#include <Arduino.h>
+
+#include "fixed_point.h"
+
+static const int N_SAMPLES = 256;
+static const int ROUNDS = 8;
+
+#ifdef BENCH_FLOAT
+static float temps[N_SAMPLES];
+static float hums[N_SAMPLES];
+#else
+static centi_t temps[N_SAMPLES];
+static centi_t hums[N_SAMPLES];
+#endif
+
+static volatile uint32_t sink;
+
+static void fillSamples() {
+  // DHT22: resolucion 0.1, valores tipicos de invernadero
+  for (int i = 0; i < N_SAMPLES; i++) {
+    int32_t t = 1800 + (int32_t)(esp_random() % 1500);
+    int32_t h = 3500 + (int32_t)(esp_random() % 5000);
+    t -= t % 10;
+    h -= h % 10;
+#ifdef BENCH_FLOAT
+    temps[i] = t / 100.0f;
+    hums[i] = h / 100.0f;
+#else
+    temps[i] = (centi_t)t;
+    hums[i] = (centi_t)h;
+#endif
+  }
+}
+
+#ifdef BENCH_FLOAT
+static uint32_t update(int i, bool& vent) {
+  const float ref = 25.0f, hyst = 0.5f;
+  float t = temps[i], h = hums[i];
+  if (t > ref + hyst) vent = true;
+  else if (t < ref - hyst) vent = false;
+  bool water = h < 50.0f;
+
+  char oled[16], line[48], msg[64];
+  dtostrf(t, 0, 1, oled);                                 // OLED / formatFloat
+  snprintf(line, sizeof(line), "DHT: T=%.1f H=%.1f", t, h); // Serial.printf
+  dtostrf(h, 0, 1, msg);                                  // Telegram
+  return oled[0] + line[5] + msg[0] + vent + water;
+}
+#else
+// Copia s en p y devuelve el final (sin snprintf: este camino no arrastra printf)
+static char* append(char* p, const char* s) {
+  while (*s) *p++ = *s++;
+  *p = '\0';
+  return p;
+}
+
+static uint32_t update(int i, bool& vent) {
+  const centi_t ref = 2500, hyst = 50;
+  centi_t t = temps[i], h = hums[i];
+  if (t > ref + hyst) vent = true;
+  else if (t < ref - hyst) vent = false;
+  bool water = h < 5000;
+
+  char oled[16], hs[16], line[48];
+  centiToStr(oled, t, 1);
+  centiToStr(hs, h, 1);
+  char* p = append(line, "DHT: T=");   // "DHT: T=%s H=%s"
+  p += centiToStr(p, t, 1);
+  p = append(p, " H=");
+  centiToStr(p, h, 1);
+  return oled[0] + line[5] + hs[0] + vent + water;
+}
+#endif
+
+void setup() {
+  Serial.begin(115200);
+  delay(500);
+  fillSamples();
+
+  bool vent = false;
+  uint32_t best = UINT32_MAX;
+  uint64_t total = 0;
+  for (int r = 0; r < ROUNDS; r++) {
+    uint32_t c0 = ESP.getCycleCount();
+    for (int i = 0; i < N_SAMPLES; i++) sink += update(i, vent);
+    uint32_t cycles = ESP.getCycleCount() - c0;
+    total += cycles;
+    if (cycles < best) best = cycles;
+  }
+
+#ifdef BENCH_FLOAT
+  const char* path = "float";
+#else
+  const char* path = "punto fijo";
+#endif
+  // Resultados con Print (enteros), no con printf: asi la diferencia de
+  // flash entre los dos entornos es solo la del camino de formateo
+  Serial.print("Camino ");
+  Serial.print(path);
+  Serial.print(": ");
+  Serial.print((unsigned long)(total / ((uint64_t)ROUNDS * N_SAMPLES)));
+  Serial.print(" ciclos/actualizacion (mejor ronda ");
+  Serial.print((unsigned long)(best / N_SAMPLES));
+  Serial.print("), ");
+  Serial.print((unsigned long)ESP.getCpuFreqMHz());
+  Serial.println(" MHz");
+  Serial.print("Sketch: ");
+  Serial.print((unsigned long)ESP.getSketchSize());
+  Serial.println(" bytes de flash");
+}
+
+void loop() {
+  delay(1000);
+}
@@ -0,0 +1,221 @@
+#include "chart.h"
+
+#include <string.h>
+
+// --------------------- ChartImage ---------------------
+void ChartImage::clear() {
+  memset(cols, CHART_NO_DATA, sizeof(cols));
+}
+
+static void extend(uint8_t& top, uint8_t& bot, uint8_t y) {
+  if (top == CHART_NO_DATA) {
+    top = bot = y;
+    return;
+  }
+  if (y < top) top = y;
+  if (y > bot) bot = y;
+}
+
+void ChartImage::addPoint(int x, uint8_t tY, uint8_t hY) {
+  if (x < 0 || x >= WIDTH) return;
+  if (tY >= PANEL_H) tY = PANEL_H - 1;
+  if (hY >= PANEL_H) hY = PANEL_H - 1;
+  extend(cols[x].tTop, cols[x].tBot, tY);
+  extend(cols[x].hTop, cols[x].hBot, hY);
+}
+
+static void joinRange(uint8_t& top, uint8_t& bot, uint8_t prevTop, uint8_t prevBot) {
+  if (top == CHART_NO_DATA || prevTop == CHART_NO_DATA) return;
+  if (top > prevBot) top = prevBot;
+  if (bot < prevTop) bot = prevTop;
+}
+
+void ChartImage::connect() {
+  // Huecos cortos se interpolan; los largos (sin datos) quedan abiertos
+  const int MAX_GAP = 16;
+  int last = -1;
+  ChartColumn prev = {};
+  for (int x = 0; x < WIDTH; x++) {
+    ChartColumn cur = cols[x];
+    if (cur.tTop == CHART_NO_DATA) continue;
+
+    if (last >= 0 && x - last - 1 <= MAX_GAP) {
+      int t0 = (prev.tTop + prev.tBot) / 2, t1 = (cur.tTop + cur.tBot) / 2;
+      int h0 = (prev.hTop + prev.hBot) / 2, h1 = (cur.hTop + cur.hBot) / 2;
+      for (int g = last + 1; g < x; g++) {
+        int k = g - last, n = x - last;
+        addPoint(g, (uint8_t)(t0 + (t1 - t0) * k / n), (uint8_t)(h0 + (h1 - h0) * k / n));
+      }
+      // Cada columna toca a la anterior para que la linea sea continua
+      for (int g = last + 1; g <= x; g++) {
+        joinRange(cols[g].tTop, cols[g].tBot, cols[g - 1].tTop, cols[g - 1].tBot);
+        joinRange(cols[g].hTop, cols[g].hBot, cols[g - 1].hTop, cols[g - 1].hBot);
+      }
+    }
+    last = x;
+    prev = cur;
+  }
+}
+
+static inline void setInk(uint8_t* row, int x) {
+  row[x >> 3] &= (uint8_t)~(0x80u >> (x & 7));
+}
+
+void ChartImage::renderRow(int y, uint8_t* row) const {
+  memset(row, 0xFF, ROW_BYTES);
+
+  // Panel superior: temperatura, inferior: humedad
+  int panelTop;
+  bool temp;
+  if (y >= MARGIN && y < MARGIN + PANEL_H) {
+    panelTop = MARGIN;
+    temp = true;
+  } else if (y >= 2 * MARGIN + PANEL_H && y < 2 * MARGIN + 2 * PANEL_H) {
+    panelTop = 2 * MARGIN + PANEL_H;
+    temp = false;
+  } else {
+    return;
+  }
+  int py = y - panelTop;
+  const int left = MARGIN;
+  const int right = WIDTH - MARGIN - 1;
+
+  // Marco
+  if (py == 0 || py == PANEL_H - 1) {
+    for (int x = left; x <= right; x++) setInk(row, x);
+    return;
+  }
+  setInk(row, left);
+  setInk(row, right);
+
+  // Grilla punteada en cuartos
+  if (py == PANEL_H / 4 || py == PANEL_H / 2 || py == 3 * PANEL_H / 4) {
+    for (int x = left; x <= right; x += 4) setInk(row, x);
+  }
+
+  // Serie
+  for (int x = left + 1; x < right; x++) {
+    const ChartColumn& c = cols[x];
+    uint8_t top = temp ? c.tTop : c.hTop;
+    uint8_t bot = temp ? c.tBot : c.hBot;
+    if (top != CHART_NO_DATA && py >= top && py <= bot) setInk(row, x);
+  }
+}
+
+// --------------------- PngRowStream ---------------------
+enum {
+  STAGE_HEADER = 0,
+  STAGE_ROWS,
+  STAGE_TAIL,
+  STAGE_DONE
+};
+
+// CRC-32 (PNG) con tabla de 16 entradas: 64 bytes en vez de 1 KB
+static const uint32_t CRC_NIBBLE[16] = {
+  0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+  0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+static uint32_t crcUpdate(uint32_t crc, const uint8_t* p, size_t n) {
+  while (n--) {
+    crc ^= *p++;
+    crc = (crc >> 4) ^ CRC_NIBBLE[crc & 0x0F];
+    crc = (crc >> 4) ^ CRC_NIBBLE[crc & 0x0F];
+  }
+  return crc;
+}
+
+PngRowStream::PngRowStream(uint16_t w, uint16_t h, RowFn fn_, void* ctx_)
+  : width(w), height(h), fn(fn_), ctx(ctx_),
+    stage(STAGE_HEADER), row(0), crc(0), adlerA(1), adlerB(0), len(0) {
+  if (width > ChartImage::WIDTH) width = ChartImage::WIDTH;
+  rowBytes = (width + 7) / 8;
+}
+
+uint32_t PngRowStream::size() const {
+  uint32_t zlib = 2 + (uint32_t)height * (5 + 1 + rowBytes) + 4;
+  return 8 + 25 + (12 + zlib) + 12;
+}
+
+void PngRowStream::put8(uint8_t v) {
+  buf[len++] = v;
+}
+
+void PngRowStream::put32(uint32_t v) {
+  put8(v >> 24);
+  put8(v >> 16);
+  put8(v >> 8);
+  put8(v);
+}
+
+void PngRowStream::putData(const uint8_t* p, size_t n, bool idat) {
+  memcpy(buf + len, p, n);
+  if (idat) crc = crcUpdate(crc, p, n);
+  len += n;
+}
+
+bool PngRowStream::advance() {
+  len = 0;
+
+  if (stage == STAGE_HEADER) {
+    static const uint8_t SIG[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    putData(SIG, 8, false);
+
+    // IHDR: 1 bit, escala de grises
+    uint8_t ihdr[17] = { 'I', 'H', 'D', 'R',
+                         0, 0, (uint8_t)(width >> 8), (uint8_t)width,
+                         0, 0, (uint8_t)(height >> 8), (uint8_t)height,
+                         1, 0, 0, 0, 0 };
+    put32(13);
+    putData(ihdr, sizeof(ihdr), false);
+    put32(crcUpdate(0xFFFFFFFF, ihdr, sizeof(ihdr)) ^ 0xFFFFFFFF);
+
+    // IDAT: se abre aca y el CRC se arrastra fila por fila
+    put32(size() - 8 - 25 - 12 - 12);
+    static const uint8_t IDAT_HDR[6] = { 'I', 'D', 'A', 'T', 0x78, 0x01 };
+    crc = 0xFFFFFFFF;
+    putData(IDAT_HDR, sizeof(IDAT_HDR), true);
+
+    stage = height > 0 ? STAGE_ROWS : STAGE_TAIL;
+    return true;
+  }
+
+  if (stage == STAGE_ROWS) {
+    // Un bloque deflate "stored" por fila: filtro 0 + bits de la fila
+    uint16_t n = rowBytes + 1;
+    uint8_t hdr[5] = { (uint8_t)(row == height - 1 ? 1 : 0),
+                       (uint8_t)n, (uint8_t)(n >> 8),
+                       (uint8_t)~n, (uint8_t)(~n >> 8) };
+    putData(hdr, sizeof(hdr), true);
+
+    uint8_t* raw = buf + len;
+    raw[0] = 0;
+    fn(row, raw + 1, ctx);
+    crc = crcUpdate(crc, raw, n);
+    for (uint16_t i = 0; i < n; i++) {
+      adlerA = (adlerA + raw[i]) % 65521;
+      adlerB = (adlerB + adlerA) % 65521;
+    }
+    len += n;
+
+    if (++row >= height) stage = STAGE_TAIL;
+    return true;
+  }
+
+  if (stage == STAGE_TAIL) {
+    uint8_t adler[4] = { (uint8_t)(adlerB >> 8), (uint8_t)adlerB,
+                         (uint8_t)(adlerA >> 8), (uint8_t)adlerA };
+    putData(adler, sizeof(adler), true);
+    put32(crc ^ 0xFFFFFFFF);
+
+    static const uint8_t IEND[4] = { 'I', 'E', 'N', 'D' };
+    put32(0);
+    putData(IEND, sizeof(IEND), false);
+    put32(0xAE426082);
+
+    stage = STAGE_DONE;
+    return true;
+  }
+
+  return false;
+}
@@ -3,7 +3,7 @@
    - DHT22 -> GPIO4
    - OLED (SSD1306) -> SDA=21, SCL=22
    - Pot -> GPIO32
-   - Telegram commands: /start, /led<gpio><on/off>, /dht22, /pote, /platiot, /display<cmd>
+   - Telegram commands: /start, /led<gpio><on/off>, /dht22, /pote, /platiot, /display<cmd>, /wifi, /hist[min], /chart[min], /mem, /perf, /sampling, /alert, /alerts
 */
 
 #include <WiFi.h>
@@ -11,15 +11,36 @@
 #include <UniversalTelegramBot.h>
 #include <ArduinoJson.h>
 
-#include <Wire.h>
-#include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
-#include <DHT.h>
 #include <ThingSpeak.h>
 
+#include "greenhouse_core.h"
+#include "gh_sensor.h"
+#include "gh_pot.h"
+#include "gh_display.h"
+#include "gh_output.h"
+#include "gh_commands.h"
+#include "fixed_point.h"
+#include "wifi_manager.h"
+#include "ts_store.h"
+#include "chart.h"
+#include "net_perf.h"
+#include "timed_client.h"
+#include "sampling.h"
+#include "oled_service.h"
+#include "alerts.h"
+#ifdef MOCK_API_HOST
+#include "mock_redirect.h"
+#endif
+
 // -CONFIG (rellenar) ACA PONER EL SSID DE SU CELULAR, CONTRASEÑA Y EL TOKEN DEL BOOT DE TELEGRAM---------------------
 const char* WIFI_SSID = "Wokwi-GUEST";
 const char* WIFI_PASS = "";
+// IP estatica opcional (evita DHCP al reconectar). Dejar en false para usar DHCP
+const bool WIFI_USE_STATIC_IP = false;
+const IPAddress WIFI_STATIC_IP(192, 168, 1, 50);
+const IPAddress WIFI_GATEWAY(192, 168, 1, 1);
+const IPAddress WIFI_SUBNET(255, 255, 255, 0);
+const IPAddress WIFI_DNS(8, 8, 8, 8);
 
 #define BOT_TOKEN ""
 #define CHAT_ID "" // string or number
@@ -38,111 +59,288 @@ unsigned long THINGSPEAK_CHANNEL_ID = 3145865; // Reemplazar con tu Channel ID d
 #define SDA_PIN 21
 #define SCL_PIN 22
 
+#define OLED_I2C_HZ 800000 // el SSD1306 anda bien entre 400 kHz y 1 MHz
+
+// --------------------- Nucleo (lib/greenhouse_core) ---------------------
+struct Actuators {
+  DigitalOutput<LED_GREEN_PIN> green;
+  DigitalOutput<LED_BLUE_PIN> blue;
+  void begin() { green.begin(); blue.begin(); }
+  void loop(unsigned long) {}
+};
+
+GreenhouseCore<Dht22Sensor<DHTPIN, DHTTYPE>, AnalogPot<POT_PIN>,
+               Ssd1306Display<SDA_PIN, SCL_PIN, 0x3C, OLED_I2C_HZ>, Actuators,
+               SerialCommands<>> core;
+
 // --------------------- OLED ---------------------
-#define SCREEN_WIDTH 128
-#define SCREEN_HEIGHT 64
-#define OLED_RESET -1
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+// Solo la tarea de OledService dibuja; el resto del programa llama a oled.show()
+OledService oled(core.display.gfx());
 
-// --------------------- DHT ---------------------
-DHT dht(DHTPIN, DHTTYPE);
+// --------------------- WiFi ---------------------
+WifiManager wifi;
 
 // --------------------- Telegram ---------------------
-WiFiClientSecure secureClient;
+// TimedClient carga las latencias de cada request en netPerf (/perf)
+#ifdef MOCK_API_HOST
+// Benchmark offline: Telegram simulado en tools/mock_servers.py
+MockRedirect<TimedClient<WiFiClientSecure>> secureClient(MOCK_API_HOST, MOCK_TELEGRAM_PORT, "tg", true);
+#else
+TimedClient<WiFiClientSecure> secureClient("tg", true);
+#endif
 UniversalTelegramBot bot(BOT_TOKEN, secureClient);
 unsigned long lastTelegramCheck = 0;
 const unsigned long TELEGRAM_CHECK_MS = 2000; // 2s
 
 // --------------------- ThingSpeak client ---------------------
-WiFiClient thingClient;
+#ifdef MOCK_API_HOST
+MockRedirect<TimedClient<WiFiClient>> thingClient(MOCK_API_HOST, MOCK_THINGSPEAK_PORT, "ts", false);
+#else
+TimedClient<WiFiClient> thingClient("ts", false);
+#endif
 
 // --------------------- Timers y estados ---------------------
-const unsigned long DHT_INTERVAL = 2000;
-unsigned long lastDhtRead = 0;
-float currentTemp = NAN;
-float currentHum = NAN;
+// Muestreo adaptativo: 2 s mientras cambia rapido, hasta 30 s si esta estable
+const AdaptiveSampler::Config DHT_SAMPLING = {
+  2000, 30000,  // intervalo min / max (ms)
+  50, 200,      // cambio rapido: 0.5 C/min, 2 %/min
+  20, 50        // estable: hasta 0.2 C y 0.5 % entre muestras
+};
+AdaptiveSampler dhtSampler(DHT_SAMPLING);
+
+// --------------------- Alertas ---------------------
+AlertEngine alerts;
+
+// Tiempo de las alertas en segundos
+uint32_t alertsNow() {
+  return millis() / 1000;
+}
+
+bool sendAlert(const char* chatId, const String& text, void*) {
+  return bot.sendMessage(chatId, text, "");
+}
+// Temperatura y humedad en centesimas (ver fixed_point.h)
+centi_t currentTemp = CENTI_NAN;
+centi_t currentHum = CENTI_NAN;
+
+// Pantalla de inicio: a los SPLASH_MS la reemplaza la de estado (sin delay)
+const unsigned long SPLASH_MS = 1200;
+unsigned long splashStart = 0;
+bool splashActive = false;
+
+// --------------------- Historial ---------------------
+TsStore history;
+uint32_t historyTimeBase = 0; // continua el reloj del historial entre reinicios
+
+// Tiempo del historial en segundos
+uint32_t historyNow() {
+  return historyTimeBase + millis() / 1000;
+}
+
+// Resumen de un rango del historial (min / promedio / max)
+struct HistSummary {
+  uint32_t n;
+  int32_t tMin, tMax, tSum;
+  int32_t hMin, hMax, hSum;
+};
+
+bool histAccumulate(const TsSample& smp, void* ctx) {
+  HistSummary* a = (HistSummary*)ctx;
+  a->n++;
+  a->tSum += smp.temp;
+  a->hSum += smp.hum;
+  if (smp.temp < a->tMin) a->tMin = smp.temp;
+  if (smp.temp > a->tMax) a->tMax = smp.temp;
+  if (smp.hum < a->hMin) a->hMin = smp.hum;
+  if (smp.hum > a->hMax) a->hMax = smp.hum;
+  return true;
+}
 
-bool ledGreen = false;
-bool ledBlue = false;
+HistSummary histSummary(uint32_t from, uint32_t to) {
+  HistSummary sum = { 0, INT32_MAX, INT32_MIN, 0, INT32_MAX, INT32_MIN, 0 };
+  history.query(from, to, histAccumulate, &sum);
+  return sum;
+}
 
-// Control de envío a ThingSpeak (mínimo 15 segundos entre escrituras)
+// Inicio de la ventana de los ultimos 'minutes' minutos
+uint32_t historyFrom(int minutes) {
+  uint32_t now = historyNow();
+  return now > (uint32_t)minutes * 60 ? now - (uint32_t)minutes * 60 : 0;
+}
+
+// --------------------- Grafico (/chart) ---------------------
+// Se dibuja una fila a la vez directo en el multipart de sendPhoto:
+// en RAM solo quedan las columnas del grafico y el buffer de una fila
+ChartImage chartImage;
+PngRowStream* chartPng = nullptr;
+
+struct ChartFill {
+  uint32_t from, span;
+  int32_t tLo, tSpan, hLo, hSpan; // centesimas
+};
+
+uint8_t chartScaleY(int32_t v, int32_t lo, int32_t span) {
+  int32_t k = v - lo;
+  if (k < 0) k = 0;
+  if (k > span) k = span;
+  return (uint8_t)((ChartImage::PANEL_H - 1) - (k * (ChartImage::PANEL_H - 1) + span / 2) / span);
+}
+
+// Redondeo a grados / puntos enteros (en centesimas)
+int32_t centiFloor(int32_t v) { return v >= 0 ? v / 100 * 100 : -((-v + 99) / 100 * 100); }
+int32_t centiCeil(int32_t v) { return -centiFloor(-v); }
+
+bool chartAddSample(const TsSample& smp, void* ctx) {
+  ChartFill* f = (ChartFill*)ctx;
+  int x = (int)((uint64_t)(smp.t - f->from) * ChartImage::WIDTH / f->span);
+  chartImage.addPoint(x, chartScaleY(smp.temp, f->tLo, f->tSpan), chartScaleY(smp.hum, f->hLo, f->hSpan));
+  return true;
+}
+
+void chartRow(int y, uint8_t* row, void*) { chartImage.renderRow(y, row); }
+
+// Callbacks de UniversalTelegramBot::sendPhotoByBinary: advance() prepara el
+// siguiente tramo, buffer/len solo lo devuelven
+bool chartMore() { return chartPng->advance(); }
+byte* chartBuffer() { return chartPng->data(); }
+int chartBufferLen() { return (int)chartPng->length(); }
+
+// Control de envío a ThingSpeak (mínimo 15 segundos entre escrituras).
+// El limite es del canal y lo comparten la publicacion automatica y /platiot;
+// un /platiot dentro de la ventana queda pendiente y toma el proximo turno,
+// antes que la publicacion automatica
 unsigned long lastThingSpeakWrite = 0;
 const unsigned long THINGSPEAK_INTERVAL = 15000; // 15 segundos
+bool platiotPending = false;
+String platiotChat;
+
+// Publicacion automatica a ThingSpeak: solo si cambia mas de 0.3 C / 1 %
+// desde lo ultimo publicado, o cada 10 minutos como minimo
+DeadbandPublisher publisher(30, 100, 600000);
+unsigned long lastPublishTry = 0;
 
 // --------------------- Helpers ---------------------
-String formatFloat(float v, int decimals=1) {
+// Valor en centesimas -> texto, solo con enteros (sin dtostrf / printf de floats)
+String formatCenti(int32_t v, int decimals=1) {
   char buf[16];
-  dtostrf(v, 0, decimals, buf);
+  centiToStr(buf, v, decimals);
   return String(buf);
 }
 
-void showOnOLED(const String &title, const String &line2) {
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setCursor(0,0);
-  display.println(title);
-  display.setTextSize(2);
-  display.setCursor(0,20);
-  display.println(line2);
-  display.display();
+// Milivolts -> texto con 'decimals' decimales
+String formatMilli(int32_t v, int decimals=2) {
+  char buf[16];
+  fixedToStr(buf, v, 3, decimals);
+  return String(buf);
 }
 
+// Lectura del DHT por el nucleo, medida en /perf
+bool readDht(centi_t &t, centi_t &h) {
+  ScopedTimer timer("dht");
+  return core.readSensor(t, h);
+}
+
+// Pantalla de estado: ultima lectura del DHT, o la conexion si todavia no hay
+void showStatusScreen() {
+  if (centiValid(currentTemp)) {
+    oled.show("DHT22", "T:" + formatCenti(currentTemp,1) + "C H:" + formatCenti(currentHum,1) + "%");
+  } else {
+    oled.show("Invernadero", wifi.isConnected() ? "Listo" : "Sin WiFi");
+  }
+}
+
+// Envia temp/hum a ThingSpeak (field1=temp, field2=hum); devuelve el codigo HTTP
+int thingSpeakWrite(const String &sT, const String &sH) {
+  ThingSpeak.setField(1, sT);
+  ThingSpeak.setField(2, sH);
+  int response = ThingSpeak.writeFields(THINGSPEAK_CHANNEL_ID, THINGSPEAK_API_KEY);
+  if (response == 200) lastThingSpeakWrite = millis();
+  return response;
+}
+
+// --------------------- Comandos por Serial ---------------------
+void cmdPerf(const char*) { netPerf.dump(Serial); }
+void cmdSampling(const char*) { Serial.println(samplingStatsText(dhtSampler, publisher)); }
+
+const CommandEntry SERIAL_COMMANDS[] = {
+  { "perf", cmdPerf },         // latencias de red
+  { "sampling", cmdSampling }, // muestras tomadas vs publicadas
+};
+
 // --------------------- Setup ---------------------
 void setup() {
   Serial.begin(115200);
   delay(100);
 
-  // WiFi
-  WiFi.begin(WIFI_SSID, WIFI_PASS);
-  Serial.print("Connecting to WiFi");
-  unsigned long start = millis();
-  while (WiFi.status() != WL_CONNECTED && millis() - start < 20000) {
-    delay(300);
-    Serial.print(".");
-  }
-  Serial.println();
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("WiFi connected, IP: ");
-    Serial.println(WiFi.localIP());
-  } else {
-    Serial.println("WiFi connection failed!");
+  // WiFi (no bloqueante: la conexion avanza en loop())
+  if (WIFI_USE_STATIC_IP) {
+    wifi.setStaticIP(WIFI_STATIC_IP, WIFI_GATEWAY, WIFI_SUBNET, WIFI_DNS);
   }
+  wifi.begin(WIFI_SSID, WIFI_PASS);
+  Serial.println("Connecting to WiFi...");
 
   // Secure client for Telegram (HTTPS)
   secureClient.setInsecure(); // <-- simplifica (no validar certificado)
 
-  // OLED
-  Wire.begin(SDA_PIN, SCL_PIN);
-  if (!display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
+  // I2C + OLED, DHT, pote (ADC 11 dB), LEDs y comandos por Serial
+  core.commands.setTable(SERIAL_COMMANDS);
+  if (!core.begin()) {
     Serial.println("No OLED found");
   }
-  display.clearDisplay();
-  display.setTextColor(SSD1306_WHITE);
-
-  // DHT
-  dht.begin();
-
-  // Pins
-  pinMode(LED_GREEN_PIN, OUTPUT);
-  digitalWrite(LED_GREEN_PIN, LOW);
-  pinMode(LED_BLUE_PIN, OUTPUT);
-  digitalWrite(LED_BLUE_PIN, LOW);
-
-  // ADC atenuation
-  analogSetPinAttenuation(POT_PIN, ADC_11db);
+  oled.begin(); // la tarea de dibujo
 
   // ThingSpeak init
   ThingSpeak.begin(thingClient);
 
-  // Welcome
-  showOnOLED("Invernadero", "Iniciando...");
-  delay(1200);
-  display.clearDisplay();
-  display.display();
+  // Historial comprimido
+  history.begin();
+  if (history.lastTime() > 0) historyTimeBase = history.lastTime() + 1;
+
+  // Welcome: loop() la cambia por la pantalla de estado a los SPLASH_MS
+  oled.show("Invernadero", "Iniciando...");
+  splashStart = millis();
+  splashActive = true;
+}
 
-  // Send startup message to bot (opcional)
-  if (WiFi.status() == WL_CONNECTED) {
-    bot.sendMessage(CHAT_ID, "🤖 Invernadero: conectado y listo", "");
+// /platiot: lee el DHT, envia a ThingSpeak y responde al chat
+void platiotSend(const String& chat_id) {
+  centi_t t, h;
+  if (!readDht(t, h)) {
+    bot.sendMessage(chat_id, "❌ Error lectura DHT22, no se envía a IoT", "");
+    return;
+  }
+  
+  // Mostrar datos que se van a enviar
+  Serial.println("=== Enviando a ThingSpeak ===");
+  String sT = formatCenti(t,1);
+  String sH = formatCenti(h,1);
+  Serial.printf("Temperatura: %s °C\n", sT.c_str());
+  Serial.printf("Humedad: %s %%\n", sH.c_str());
+  Serial.printf("Channel ID: %lu\n", THINGSPEAK_CHANNEL_ID);
+  
+  // Enviar a ThingSpeak (field1=temp, field2=hum)
+  int response = thingSpeakWrite(sT, sH);
+  
+  Serial.printf("Respuesta ThingSpeak: %d\n", response);
+  
+  if (response == 200) {
+    publisher.published(millis(), t, h, DeadbandPublisher::MANUAL);
+    String msg = "✅ Datos enviados a ThingSpeak OK\n";
+    msg += "🌡️ Temp: " + sT + " °C\n";
+    msg += "💧 Hum: " + sH + " %";
+    bot.sendMessage(chat_id, msg, "");
+  } else {
+    String errorMsg = "❌ Error al enviar a ThingSpeak\nCódigo: " + String(response) + "\n";
+    if (response == 0) {
+      errorMsg += "Causa: Sin conexión a Internet";
+    } else if (response == 400) {
+      errorMsg += "Causa: API Key o Channel ID inválidos";
+    } else if (response == 404) {
+      errorMsg += "Causa: Canal no encontrado";
+    } else if (response == -301) {
+      errorMsg += "Causa: Tiempo de espera agotado";
+    }
+    bot.sendMessage(chat_id, errorMsg, "");
   }
 }
 
@@ -161,7 +359,13 @@ void handleTelegramMessage(int i) {
     welcome += "/dht22\n";
     welcome += "/pote\n";
     welcome += "/platiot\n";
-    welcome += "/displayled /displaypote /displaydht\n";
+    welcome += "/displayled /displaypote /displaydht /displaystats\n";
+    welcome += "/wifi\n";
+    welcome += "/hist /hist<minutos>\n";
+    welcome += "/chart /chart<minutos>\n";
+    welcome += "/mem /perf /sampling\n";
+    welcome += "/alert temp>30 /alert hum<40 for 5m\n";
+    welcome += "/alerts /alert del <n> /alert clear\n";
     bot.sendMessage(chat_id, welcome, "");
     return;
   }
@@ -182,13 +386,11 @@ void handleTelegramMessage(int i) {
     int pin = sPin.toInt();
     if (pin == LED_GREEN_PIN || pin == LED_BLUE_PIN) {
       // valid pin
+      if (pin == LED_GREEN_PIN) core.actuators.green.set(turnOn);
+      else core.actuators.blue.set(turnOn);
       if (turnOn) {
-        digitalWrite(pin, HIGH);
-        if (pin == LED_GREEN_PIN) ledGreen = true; else ledBlue = true;
         bot.sendMessage(chat_id, "LED encendido en pin " + String(pin), "");
       } else {
-        digitalWrite(pin, LOW);
-        if (pin == LED_GREEN_PIN) ledGreen = false; else ledBlue = false;
         bot.sendMessage(chat_id, "LED apagado en pin " + String(pin), "");
       }
       return;
@@ -200,12 +402,11 @@ void handleTelegramMessage(int i) {
 
   // /dht22
   if (text == "/dht22") {
-    float h = dht.readHumidity();
-    float t = dht.readTemperature();
-    if (isnan(h) || isnan(t)) {
+    centi_t t, h;
+    if (!readDht(t, h)) {
       bot.sendMessage(chat_id, "Error lectura DHT22", "");
     } else {
-      String msg = "Temp: " + formatFloat(t,1) + " C\nHum: " + formatFloat(h,1) + " %";
+      String msg = "Temp: " + formatCenti(t,1) + " C\nHum: " + formatCenti(h,1) + " %";
       bot.sendMessage(chat_id, msg, "");
     }
     return;
@@ -213,89 +414,171 @@ void handleTelegramMessage(int i) {
 
   // /pote
   if (text == "/pote") {
-    int potRaw = analogRead(POT_PIN);
-    float volts = (potRaw / 4095.0f) * 3.3f;
-    String msg = "Pot raw: " + String(potRaw) + "\nVolt: " + formatFloat(volts,2) + " V";
+    int potRaw = core.pot.raw();
+    String msg = "Pot raw: " + String(potRaw) + "\nVolt: " + formatMilli(core.pot.toMillivolts(potRaw),2) + " V";
     bot.sendMessage(chat_id, msg, "");
     return;
   }
 
   // /platiot -> enviar a ThingSpeak (ejemplo)
   if (text == "/platiot") {
-    // Verificar tiempo mínimo entre escrituras (15 segundos)
+    // Verificar tiempo mínimo entre escrituras (15 segundos): si no paso, se
+    // envia en el proximo turno desde loop()
     unsigned long currentTime = millis();
     if (currentTime - lastThingSpeakWrite < THINGSPEAK_INTERVAL) {
-      unsigned long waitTime = (THINGSPEAK_INTERVAL - (currentTime - lastThingSpeakWrite)) / 1000;
-      bot.sendMessage(chat_id, "⏳ Espera " + String(waitTime) + " segundos antes de enviar datos nuevamente", "");
+      unsigned long waitTime = (THINGSPEAK_INTERVAL - (currentTime - lastThingSpeakWrite) + 999) / 1000;
+      platiotPending = true;
+      platiotChat = chat_id;
+      bot.sendMessage(chat_id, "⏳ ThingSpeak acepta una escritura cada " + String(THINGSPEAK_INTERVAL / 1000) +
+                      " s\nSe envía en " + String(waitTime) + " segundos", "");
       return;
     }
-    
-    float h = dht.readHumidity();
-    float t = dht.readTemperature();
-    if (isnan(h) || isnan(t)) {
-      bot.sendMessage(chat_id, "❌ Error lectura DHT22, no se envía a IoT", "");
-      return;
-    }
-    
-    // Mostrar datos que se van a enviar
-    Serial.println("=== Enviando a ThingSpeak ===");
-    Serial.printf("Temperatura: %.1f °C\n", t);
-    Serial.printf("Humedad: %.1f %%\n", h);
-    Serial.printf("Channel ID: %lu\n", THINGSPEAK_CHANNEL_ID);
-    
-    // Enviar a ThingSpeak (field1=temp, field2=hum)
-    ThingSpeak.setField(1, t);
-    ThingSpeak.setField(2, h);
-    int response = ThingSpeak.writeFields(THINGSPEAK_CHANNEL_ID, THINGSPEAK_API_KEY);
-    
-    Serial.printf("Respuesta ThingSpeak: %d\n", response);
-    
-    if (response == 200) {
-      lastThingSpeakWrite = currentTime; // Actualizar timestamp solo si fue exitoso
-      String msg = "✅ Datos enviados a ThingSpeak OK\n";
-      msg += "🌡️ Temp: " + formatFloat(t,1) + " °C\n";
-      msg += "💧 Hum: " + formatFloat(h,1) + " %";
-      bot.sendMessage(chat_id, msg, "");
+
+    platiotSend(chat_id);
+    return;
+  }
+
+  // /wifi -> estadisticas de conexion
+  if (text == "/wifi") {
+    bot.sendMessage(chat_id, wifi.statsText(), "");
+    return;
+  }
+
+  // /mem -> uso de memoria (lo usa tools/bench.py para el maximo de heap)
+  if (text == "/mem") {
+    String msg = "Heap libre: " + String(ESP.getFreeHeap()) + "\n";
+    msg += "Heap minimo: " + String(ESP.getMinFreeHeap()) + "\n";
+    msg += "Bloque max: " + String(ESP.getMaxAllocHeap()) + "\n";
+    msg += "Heap total: " + String(ESP.getHeapSize());
+    bot.sendMessage(chat_id, msg, "");
+    return;
+  }
+
+  // /alerts -> reglas del chat y estadisticas
+  if (text == "/alerts") {
+    String rules = alerts.list(strtoll(chat_id.c_str(), nullptr, 10));
+    if (rules.length() == 0) rules = "Sin alertas. Ej: /alert temp>30 o /alert hum<40 for 5m\n";
+    bot.sendMessage(chat_id, rules + "\n" + alerts.statsText(), "");
+    return;
+  }
+
+  // /alert <regla> | /alert del <n> | /alert clear
+  if (text.startsWith("/alert")) {
+    String arg = text.substring(6);
+    arg.trim();
+    int64_t chat = strtoll(chat_id.c_str(), nullptr, 10);
+    if (arg == "clear") {
+      bot.sendMessage(chat_id, "Alertas borradas: " + String(alerts.removeAll(chat)), "");
+    } else if (arg.startsWith("del")) {
+      int id = arg.substring(3).toInt();
+      bool ok = id > 0 && alerts.remove(chat, (uint16_t)id);
+      bot.sendMessage(chat_id, ok ? "Alerta #" + String(id) + " borrada" : String("No existe esa alerta"), "");
     } else {
-      String errorMsg = "❌ Error al enviar a ThingSpeak\nCódigo: " + String(response) + "\n";
-      if (response == 0) {
-        errorMsg += "Causa: Sin conexión a Internet";
-      } else if (response == 400) {
-        errorMsg += "Causa: API Key o Channel ID inválidos";
-      } else if (response == 404) {
-        errorMsg += "Causa: Canal no encontrado";
-      } else if (response == -301) {
-        errorMsg += "Causa: Tiempo de espera agotado";
+      AlertEngine::Spec spec;
+      if (!AlertEngine::parse(arg.c_str(), spec)) {
+        bot.sendMessage(chat_id, "Uso: /alert temp>30 | /alert hum<40 for 5m (s, m, h)", "");
+        return;
       }
-      bot.sendMessage(chat_id, errorMsg, "");
+      int id = alerts.add(chat, spec, alertsNow());
+      if (id == -1) bot.sendMessage(chat_id, "Tabla de alertas llena", "");
+      else if (id == -2) bot.sendMessage(chat_id, "Maximo " + String(AlertEngine::MAX_PER_CHAT) + " alertas por chat", "");
+      else bot.sendMessage(chat_id, "Alerta #" + String(id) + ": " + AlertEngine::specText(spec), "");
     }
     return;
   }
 
+  // /sampling -> muestras tomadas vs publicadas
+  if (text == "/sampling") {
+    bot.sendMessage(chat_id, samplingStatsText(dhtSampler, publisher), "");
+    return;
+  }
+
+  // /perf -> latencias de red por endpoint y fase
+  if (text == "/perf") {
+    netPerf.dump(Serial);
+    bot.sendMessage(chat_id, netPerf.report(), "");
+    return;
+  }
+
+  // /hist[min] -> resumen del historial (default 60 minutos)
+  if (text.startsWith("/hist")) {
+    int minutes = text.substring(5).toInt();
+    if (minutes <= 0) minutes = 60;
+    HistSummary sum = histSummary(historyFrom(minutes), historyNow());
+
+    String msg = "Ultimos " + String(minutes) + " min: " + String(sum.n) + " muestras\n";
+    if (sum.n > 0) {
+      msg += "Temp min/prom/max: " + formatCenti(sum.tMin,1) + " / " + formatCenti(sum.tSum / (int32_t)sum.n,1) + " / " + formatCenti(sum.tMax,1) + " C\n";
+      msg += "Hum min/prom/max: " + formatCenti(sum.hMin,1) + " / " + formatCenti(sum.hSum / (int32_t)sum.n,1) + " / " + formatCenti(sum.hMax,1) + " %\n";
+    }
+    msg += history.statsText();
+    bot.sendMessage(chat_id, msg, "");
+    return;
+  }
+
+  // /chart[min] -> grafico PNG del historial (default 60 minutos)
+  if (text.startsWith("/chart")) {
+    int minutes = text.substring(6).toInt();
+    if (minutes <= 0) minutes = 60;
+    uint32_t now = historyNow();
+    uint32_t from = historyFrom(minutes);
+
+    // Pasada 1: escala; pasada 2: columnas
+    HistSummary sum = histSummary(from, now);
+    if (sum.n == 0) {
+      bot.sendMessage(chat_id, "Sin historial para graficar", "");
+      return;
+    }
+    ChartFill fill;
+    fill.from = from;
+    fill.span = now - from + 1;
+    fill.tLo = centiFloor(sum.tMin - 50);
+    fill.tSpan = max(centiCeil(sum.tMax + 50) - fill.tLo, (int32_t)200);
+    fill.hLo = centiFloor(sum.hMin - 100);
+    fill.hSpan = max(centiCeil(sum.hMax + 100) - fill.hLo, (int32_t)400);
+
+    chartImage.clear();
+    history.query(from, now, chartAddSample, &fill);
+    chartImage.connect();
+
+    PngRowStream png(ChartImage::WIDTH, ChartImage::HEIGHT, chartRow, nullptr);
+    chartPng = &png;
+    String res = bot.sendPhotoByBinary(chat_id, "image/png", png.size(),
+                                       chartMore, nullptr, chartBuffer, chartBufferLen);
+    chartPng = nullptr;
+
+    String msg = "Ultimos " + String(minutes) + " min (" + String(sum.n) + " muestras)\n";
+    msg += "Arriba temp: " + formatCenti(fill.tLo,0) + " a " + formatCenti(fill.tLo + fill.tSpan,0) + " C\n";
+    msg += "Abajo hum: " + formatCenti(fill.hLo,0) + " a " + formatCenti(fill.hLo + fill.hSpan,0) + " %";
+    if (res.length() == 0) msg = "Error enviando grafico";
+    bot.sendMessage(chat_id, msg, "");
+    return;
+  }
+
   // /display<cmd> -> mostrar estado en OLED
   if (text.startsWith("/display")) {
     String cmd = text.substring(8); // after "/display"
+    splashActive = false;
     if (cmd == "led") {
-      String s = "LED23: " + String(ledGreen ? "ON" : "OFF") + "\nLED2: " + String(ledBlue ? "ON" : "OFF");
-      showOnOLED("STATUS LEDs", s);
+      String s = "LED23: " + String(core.actuators.green.get() ? "ON" : "OFF") + "\nLED2: " + String(core.actuators.blue.get() ? "ON" : "OFF");
+      oled.show("STATUS LEDs", s);
       bot.sendMessage(chat_id, "OLED: mostrado estado de LEDs", "");
     } else if (cmd == "pote") {
-      int potRaw = analogRead(POT_PIN);
-      float volts = (potRaw / 4095.0f) * 3.3f;
-      showOnOLED("POT", String(formatFloat(volts,2)) + " V");
+      oled.show("POT", formatMilli(core.pot.millivolts(),2) + " V");
       bot.sendMessage(chat_id, "OLED: mostrado estado pot", "");
     } else if (cmd == "dht") {
-      float h = dht.readHumidity();
-      float t = dht.readTemperature();
-      if (isnan(h) || isnan(t)) {
-        showOnOLED("DHT22", "Error lectura");
+      centi_t t, h;
+      if (!readDht(t, h)) {
+        oled.show("DHT22", "Error lectura");
         bot.sendMessage(chat_id, "OLED: error lectura DHT", "");
       } else {
-        showOnOLED("DHT22", "T:" + formatFloat(t,1) + "C H:" + formatFloat(h,1) + "%");
+        oled.show("DHT22", "T:" + formatCenti(t,1) + "C H:" + formatCenti(h,1) + "%");
         bot.sendMessage(chat_id, "OLED: mostrado estado DHT", "");
       }
+    } else if (cmd == "stats") {
+      bot.sendMessage(chat_id, oled.statsText(), "");
     } else {
-      showOnOLED("DISPLAY", "Comando no reconocido");
+      oled.show("DISPLAY", "Comando no reconocido");
       bot.sendMessage(chat_id, "OLED: comando display no reconocido", "");
     }
     return;
@@ -307,22 +590,66 @@ void handleTelegramMessage(int i) {
 
 // --------------------- Main loop ---------------------
 void loop() {
-  // 1) DHT sampling periodic (non-blocking)
-  if (millis() - lastDhtRead >= DHT_INTERVAL) {
-    lastDhtRead = millis();
-    float h = dht.readHumidity();
-    float t = dht.readTemperature();
-    if (!isnan(h) && !isnan(t)) {
+  // 0) WiFi state machine
+  wifi.loop();
+  static bool startupSent = false;
+  if (wifi.justConnected()) {
+    wifi.printStats(Serial);
+    // Send startup message to bot (opcional), solo la primera vez
+    if (!startupSent) {
+      bot.sendMessage(CHAT_ID, "🤖 Invernadero: conectado y listo", "");
+      startupSent = true;
+    }
+  }
+
+  // 1) DHT sampling adaptativo (non-blocking)
+  if (dhtSampler.due(millis())) {
+    unsigned long now = millis();
+    centi_t t, h;
+    if (readDht(t, h)) {
+      dhtSampler.update(now, t, h);
       currentHum = h;
       currentTemp = t;
-      Serial.printf("DHT: T=%.1f H=%.1f\n", t, h);
+      history.append(historyNow(), t, h);
+      alerts.sample(alertsNow(), t, h);
+      // Solo se publica lo que supera la banda muerta (o el silencio maximo);
+      // si ThingSpeak no acepta, la proxima muestra lo reintenta
+      DeadbandPublisher::Reason reason = publisher.offer(now, t, h);
+      if (reason != DeadbandPublisher::SKIP && !platiotPending && wifi.isConnected() &&
+          now - lastThingSpeakWrite >= THINGSPEAK_INTERVAL &&
+          now - lastPublishTry >= THINGSPEAK_INTERVAL) {
+        lastPublishTry = now;
+        String sT = formatCenti(t,1);
+        String sH = formatCenti(h,1);
+        int response = thingSpeakWrite(sT, sH);
+        Serial.printf("DHT: T=%s H=%s -> ThingSpeak %d (cada %lu ms)\n", sT.c_str(), sH.c_str(),
+                      response, (unsigned long)dhtSampler.intervalMs());
+        if (response == 200) publisher.published(now, t, h, reason);
+      }
     } else {
+      dhtSampler.error(now);
       Serial.println("DHT error");
     }
   }
 
+  // 1a) /platiot pendiente: primer turno libre del canal
+  if (platiotPending && wifi.isConnected() && millis() - lastThingSpeakWrite >= THINGSPEAK_INTERVAL) {
+    platiotPending = false;
+    platiotSend(platiotChat);
+  }
+
+  // 1b) Fin de la pantalla de inicio
+  if (splashActive && millis() - splashStart >= SPLASH_MS) {
+    splashActive = false;
+    showStatusScreen();
+  }
+
+  // 1c) Alertas: reglas con "for" vencidas y envio agrupado por chat
+  alerts.tick(alertsNow());
+  if (wifi.isConnected()) alerts.flush(sendAlert, nullptr);
+
   // 2) Check Telegram updates (polling)
-  if (millis() - lastTelegramCheck > TELEGRAM_CHECK_MS) {
+  if (wifi.isConnected() && millis() - lastTelegramCheck > TELEGRAM_CHECK_MS) {
     int numNew = bot.getUpdates(bot.last_message_received + 1);
     while (numNew) {
       for (int i = 0; i < numNew; i++) handleTelegramMessage(i);
@@ -331,6 +658,9 @@ void loop() {
     lastTelegramCheck = millis();
   }
 
+  // 3) Comandos por Serial (ver SERIAL_COMMANDS)
+  core.loop(millis());
+
   // small idle
   delay(10);
 }
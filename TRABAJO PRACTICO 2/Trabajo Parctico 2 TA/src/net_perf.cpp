@@ -0,0 +1,89 @@
+#include "net_perf.h"
+
+NetPerf netPerf;
+
+// Limites superiores (exclusivos) de cada bucket, en ms: ~x1.5 por bucket
+static const uint32_t BUCKET_LIMIT[LatencyHistogram::BUCKETS] = {
+  1, 2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256,
+  384, 512, 768, 1024, 1536, 2048, 3072, 4096, 6144, 8192, 12288, 16384,
+  24576, 32768, 49152, UINT32_MAX
+};
+
+static const char* PHASE_NAMES[PHASE_COUNT] = {
+  "dns", "tcp", "tls", "req", "1er byte", "cuerpo", "total"
+};
+
+// --------------------- LatencyHistogram ---------------------
+void LatencyHistogram::add(uint32_t ms) {
+  int i = 0;
+  while (ms >= BUCKET_LIMIT[i]) i++;
+  if (buckets[i] < UINT16_MAX) buckets[i]++;
+  n++;
+  if (ms > maxMs) maxMs = ms;
+}
+
+uint32_t LatencyHistogram::percentile(uint8_t p) const {
+  if (n == 0) return 0;
+  uint32_t rank = (n * p + 99) / 100;
+  if (rank == 0) rank = 1;
+  uint32_t acc = 0;
+  for (int i = 0; i < BUCKETS; i++) {
+    acc += buckets[i];
+    if (acc >= rank) return BUCKET_LIMIT[i] - 1 < maxMs ? BUCKET_LIMIT[i] - 1 : maxMs;
+  }
+  return maxMs;
+}
+
+// --------------------- NetPerf ---------------------
+int NetPerf::endpoint(const char* name) {
+  for (int i = 0; i < used; i++) {
+    if (strncmp(endpoints[i].name, name, NAME_LEN - 1) == 0) return i;
+  }
+  if (used >= MAX_ENDPOINTS) return -1;
+  Endpoint& e = endpoints[used];
+  strncpy(e.name, name, NAME_LEN - 1);
+  e.name[NAME_LEN - 1] = '\0';
+  e.minFreeHeap = UINT32_MAX;
+  e.minMaxBlock = UINT32_MAX;
+  return used++;
+}
+
+void NetPerf::record(int ep, NetPhase phase, uint32_t ms) {
+  if (ep < 0 || ep >= used) return;
+  endpoints[ep].phases[phase].add(ms);
+}
+
+void NetPerf::sampleHeap(int ep) {
+  if (ep < 0 || ep >= used) return;
+  Endpoint& e = endpoints[ep];
+  e.lastFreeHeap = ESP.getFreeHeap();
+  e.lastMaxBlock = ESP.getMaxAllocHeap();
+  if (e.lastFreeHeap < e.minFreeHeap) e.minFreeHeap = e.lastFreeHeap;
+  if (e.lastMaxBlock < e.minMaxBlock) e.minMaxBlock = e.lastMaxBlock;
+  e.heapSamples++;
+}
+
+String NetPerf::report() const {
+  String out = "Latencias p50/p95/max (ms)\n";
+  for (int i = 0; i < used; i++) {
+    const Endpoint& e = endpoints[i];
+    out += "\n" + String(e.name) + " (n=" + String(e.phases[PHASE_TOTAL].count()) + ")\n";
+    for (int ph = 0; ph < PHASE_COUNT; ph++) {
+      const LatencyHistogram& h = e.phases[ph];
+      if (h.count() == 0) continue;
+      out += " " + String(PHASE_NAMES[ph]) + ": " + String(h.percentile(50)) + "/" +
+             String(h.percentile(95)) + "/" + String(h.max()) + "\n";
+    }
+    if (e.heapSamples > 0) {
+      out += " heap min " + String(e.minFreeHeap) + ", bloque min " + String(e.minMaxBlock) + "\n";
+    }
+  }
+  out += "\nHeap ahora: " + String(ESP.getFreeHeap()) + ", bloque max " + String(ESP.getMaxAllocHeap());
+  return out;
+}
+
+void NetPerf::dump(Print& out) const {
+  out.println("=== PERF ===");
+  out.println(report());
+  out.println("============");
+}
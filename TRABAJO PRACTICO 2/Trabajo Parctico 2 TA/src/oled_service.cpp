@@ -0,0 +1,84 @@
+#include "oled_service.h"
+
+// La tarea corre en el nucleo 0 (loop() y Telegram en el 1) con prioridad baja
+static const uint32_t OLED_TASK_STACK = 4096;
+static const UBaseType_t OLED_TASK_PRIORITY = 1;
+static const BaseType_t OLED_TASK_CORE = 0;
+
+OledService::OledService(Adafruit_SSD1306& display)
+  : display(display), task(nullptr), pending(false) {
+  lock = portMUX_INITIALIZER_UNLOCKED;
+  memset(&back, 0, sizeof(back));
+  memset(&front, 0, sizeof(front));
+  memset(&stats, 0, sizeof(stats));
+}
+
+void OledService::begin() {
+  // Sin display la tarea igual consume las pantallas (no se acumulan)
+  xTaskCreatePinnedToCore(taskEntry, "oled", OLED_TASK_STACK, this,
+                          OLED_TASK_PRIORITY, &task, OLED_TASK_CORE);
+}
+
+void OledService::show(const String& title, const String& body) {
+  portENTER_CRITICAL(&lock);
+  strlcpy(back.title, title.c_str(), sizeof(back.title));
+  strlcpy(back.body, body.c_str(), sizeof(back.body));
+  if (pending) stats.dropped++;
+  pending = true;
+  stats.submitted++;
+  portEXIT_CRITICAL(&lock);
+  if (task != nullptr) xTaskNotifyGive(task);
+}
+
+void OledService::taskEntry(void* arg) {
+  static_cast<OledService*>(arg)->run();
+}
+
+void OledService::run() {
+  TickType_t lastFrame = xTaskGetTickCount();
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    // Limita la tasa de cuadros; lo que llegue mientras tanto pisa el buffer
+    TickType_t elapsed = xTaskGetTickCount() - lastFrame;
+    if (elapsed < pdMS_TO_TICKS(MIN_FRAME_MS)) vTaskDelay(pdMS_TO_TICKS(MIN_FRAME_MS) - elapsed);
+    lastFrame = xTaskGetTickCount();
+
+    portENTER_CRITICAL(&lock);
+    bool have = pending;
+    if (have) {
+      front = back;
+      pending = false;
+    }
+    portEXIT_CRITICAL(&lock);
+    if (!have) continue;
+
+    uint32_t t0 = micros();
+    render(front);
+    uint32_t us = micros() - t0;
+    stats.frames++;
+    stats.lastFlushUs = us;
+    if (us > stats.maxFlushUs) stats.maxFlushUs = us;
+  }
+}
+
+void OledService::render(const Screen& s) {
+  display.clearDisplay();
+  display.setTextSize(1);
+  display.setCursor(0,0);
+  display.println(s.title);
+  display.setTextSize(2);
+  display.setCursor(0,20);
+  display.println(s.body);
+  display.display();
+}
+
+String OledService::statsText() const {
+  char buf[160];
+  snprintf(buf, sizeof(buf),
+           "OLED: pedidas %lu, dibujadas %lu, descartadas %lu\n"
+           "Envio: ult %lu us, max %lu us",
+           (unsigned long)stats.submitted, (unsigned long)stats.frames,
+           (unsigned long)stats.dropped,
+           (unsigned long)stats.lastFlushUs, (unsigned long)stats.maxFlushUs);
+  return String(buf);
+}
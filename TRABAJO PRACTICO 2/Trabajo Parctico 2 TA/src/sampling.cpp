@@ -0,0 +1,91 @@
+#include "sampling.h"
+
+static int32_t absDiff(centi_t a, centi_t b) {
+  int32_t d = (int32_t)a - b;
+  return d < 0 ? -d : d;
+}
+
+// --------------------- AdaptiveSampler ---------------------
+AdaptiveSampler::AdaptiveSampler(const Config& cfg)
+  : cfg(cfg), interval(cfg.minIntervalMs), lastSample(0),
+    hasLast(false), lastTemp(CENTI_NAN), lastHum(CENTI_NAN) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+void AdaptiveSampler::update(unsigned long now, centi_t temp, centi_t hum) {
+  uint32_t dt = now - lastSample;
+  stats.samples++;
+
+  if (hasLast && dt > 0) {
+    int32_t dT = absDiff(temp, lastTemp);
+    int32_t dH = absDiff(hum, lastHum);
+    // Cambio por minuto sin dividir: d * 60000 >= limite * dt. Solo cuenta
+    // si supera el umbral de estable: con dt = 2 s un LSB del DHT22
+    // (0.1 = 10 centesimas) ya da 3 C/min y fijaria el intervalo minimo
+    bool fast = (dT > cfg.quietTemp && (uint64_t)dT * 60000 >= (uint64_t)cfg.fastTempPerMin * dt) ||
+                (dH > cfg.quietHum && (uint64_t)dH * 60000 >= (uint64_t)cfg.fastHumPerMin * dt);
+    if (fast) {
+      if (interval != cfg.minIntervalMs) stats.speedUps++;
+      interval = cfg.minIntervalMs;
+    } else if (dT <= cfg.quietTemp && dH <= cfg.quietHum && interval < cfg.maxIntervalMs) {
+      interval += interval / 2;
+      if (interval > cfg.maxIntervalMs) interval = cfg.maxIntervalMs;
+      stats.backOffs++;
+    }
+  }
+
+  lastSample = now;
+  lastTemp = temp;
+  lastHum = hum;
+  hasLast = true;
+}
+
+void AdaptiveSampler::error(unsigned long now) {
+  // Reintento pronto: el intervalo minimo respeta el tiempo del sensor
+  stats.errors++;
+  interval = cfg.minIntervalMs;
+  lastSample = now;
+}
+
+// --------------------- DeadbandPublisher ---------------------
+DeadbandPublisher::DeadbandPublisher(centi_t tempBand, centi_t humBand, uint32_t maxSilenceMs)
+  : tempBand(tempBand), humBand(humBand), maxSilenceMs(maxSilenceMs),
+    hasLast(false), lastPublish(0),
+    lastTemp(CENTI_NAN), lastHum(CENTI_NAN) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+DeadbandPublisher::Reason DeadbandPublisher::offer(unsigned long now, centi_t temp, centi_t hum) {
+  stats.offered++;
+  if (!hasLast) return FIRST;
+  if (absDiff(temp, lastTemp) > tempBand || absDiff(hum, lastHum) > humBand) return CHANGE;
+  if (now - lastPublish >= maxSilenceMs) return SILENCE;
+  return SKIP;
+}
+
+void DeadbandPublisher::published(unsigned long now, centi_t temp, centi_t hum, Reason reason) {
+  stats.published++;
+  if (reason == SILENCE) stats.bySilence++;
+  lastPublish = now;
+  lastTemp = temp;
+  lastHum = hum;
+  hasLast = true;
+}
+
+// --------------------- Texto ---------------------
+String samplingStatsText(const AdaptiveSampler& sampler, const DeadbandPublisher& publisher) {
+  const AdaptiveSampler::Stats& s = sampler.getStats();
+  const DeadbandPublisher::Stats& p = publisher.getStats();
+  char buf[256];
+  snprintf(buf, sizeof(buf),
+           "Muestreo: intervalo actual %lu ms\n"
+           "Muestras: %lu (errores %lu)\n"
+           "Aceleraciones %lu, alargues %lu\n"
+           "Publicadas: %lu de %lu (por silencio %lu)",
+           (unsigned long)sampler.intervalMs(),
+           (unsigned long)s.samples, (unsigned long)s.errors,
+           (unsigned long)s.speedUps, (unsigned long)s.backOffs,
+           (unsigned long)p.published, (unsigned long)p.offered,
+           (unsigned long)p.bySilence);
+  return String(buf);
+}
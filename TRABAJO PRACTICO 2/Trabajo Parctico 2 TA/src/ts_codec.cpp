@@ -0,0 +1,183 @@
+#include "ts_codec.h"
+
+#include <string.h>
+
+static uint32_t valueBits(centi_t v) {
+  return (uint32_t)(int32_t)v;
+}
+
+static centi_t bitsValue(uint32_t u) {
+  return (centi_t)(int32_t)u;
+}
+
+static uint8_t leadingZeros(uint32_t v) {
+  return v == 0 ? 32 : (uint8_t)__builtin_clz(v);
+}
+
+static uint8_t trailingZeros(uint32_t v) {
+  return v == 0 ? 32 : (uint8_t)__builtin_ctz(v);
+}
+
+// --------------------- Encoder ---------------------
+void TsBlockEncoder::reset(uint8_t* buf_, size_t size) {
+  buf = buf_;
+  capBits = (uint32_t)size * 8;
+  memset(buf, 0, size);
+  bitPos = 0;
+  n = 0;
+  t0 = 0;
+  prevT = 0;
+  prevDelta = 0;
+  temp = ValueState{0, 0xFF, 0};
+  hum = ValueState{0, 0xFF, 0};
+}
+
+void TsBlockEncoder::writeBits(uint32_t v, uint8_t bits) {
+  // MSB primero; el buffer arranca en cero, solo se escriben los unos
+  while (bits > 0) {
+    bits--;
+    if ((v >> bits) & 1u) buf[bitPos >> 3] |= (uint8_t)(0x80u >> (bitPos & 7));
+    bitPos++;
+  }
+}
+
+void TsBlockEncoder::encodeValue(centi_t v, ValueState& st) {
+  uint32_t cur = valueBits(v);
+  uint32_t x = cur ^ st.prev;
+  st.prev = cur;
+
+  if (x == 0) {
+    writeBits(0, 1);
+    return;
+  }
+  writeBits(1, 1);
+
+  uint8_t lead = leadingZeros(x);
+  uint8_t trail = trailingZeros(x);
+  if (lead > 31) lead = 31;
+
+  if (st.lead != 0xFF && lead >= st.lead && trail >= st.trail) {
+    // Cabe en la ventana anterior: solo los bits significativos
+    writeBits(0, 1);
+    uint8_t len = 32 - st.lead - st.trail;
+    writeBits(x >> st.trail, len);
+  } else {
+    uint8_t len = 32 - lead - trail;
+    writeBits(1, 1);
+    writeBits(lead, 5);
+    writeBits(len - 1, 5);
+    writeBits(x >> trail, len);
+    st.lead = lead;
+    st.trail = trail;
+  }
+}
+
+bool TsBlockEncoder::append(const TsSample& s) {
+  if (bitPos + TS_MAX_SAMPLE_BITS > capBits) return false;
+
+  if (n == 0) {
+    t0 = s.t;
+    prevT = s.t;
+    prevDelta = 0;
+    writeBits(s.t, 32);
+    temp.prev = valueBits(s.temp);
+    hum.prev = valueBits(s.hum);
+    writeBits(temp.prev, 32);
+    writeBits(hum.prev, 32);
+    n = 1;
+    return true;
+  }
+
+  int32_t delta = (int32_t)(s.t - prevT);
+  int32_t dod = delta - prevDelta;
+  if (dod == 0) {
+    writeBits(0, 1);
+  } else if (dod >= -63 && dod <= 64) {
+    writeBits(0x2, 2);
+    writeBits((uint32_t)(dod + 63), 7);
+  } else if (dod >= -255 && dod <= 256) {
+    writeBits(0x6, 3);
+    writeBits((uint32_t)(dod + 255), 9);
+  } else if (dod >= -2047 && dod <= 2048) {
+    writeBits(0xE, 4);
+    writeBits((uint32_t)(dod + 2047), 12);
+  } else {
+    writeBits(0xF, 4);
+    writeBits((uint32_t)dod, 32);
+  }
+  prevDelta = delta;
+  prevT = s.t;
+
+  encodeValue(s.temp, temp);
+  encodeValue(s.hum, hum);
+  n++;
+  return true;
+}
+
+// --------------------- Decoder ---------------------
+TsBlockDecoder::TsBlockDecoder(const uint8_t* buf_, uint32_t bits, uint16_t count)
+  : buf(buf_), capBits(bits), bitPos(0), total(count), n(0),
+    prevT(0), prevDelta(0) {
+  temp = ValueState{0, 0, 0};
+  hum = ValueState{0, 0, 0};
+}
+
+uint32_t TsBlockDecoder::readBits(uint8_t bits) {
+  uint32_t v = 0;
+  while (bits > 0) {
+    bits--;
+    v = (v << 1) | ((buf[bitPos >> 3] >> (7 - (bitPos & 7))) & 1u);
+    bitPos++;
+  }
+  return v;
+}
+
+centi_t TsBlockDecoder::decodeValue(ValueState& st) {
+  if (readBits(1) == 0) return bitsValue(st.prev);
+
+  if (readBits(1) == 1) {
+    st.lead = (uint8_t)readBits(5);
+    uint8_t len = (uint8_t)readBits(5) + 1;
+    st.trail = 32 - st.lead - len;
+  }
+  uint8_t len = 32 - st.lead - st.trail;
+  uint32_t x = readBits(len) << st.trail;
+  st.prev ^= x;
+  return bitsValue(st.prev);
+}
+
+bool TsBlockDecoder::next(TsSample& out) {
+  if (n >= total || bitPos >= capBits) return false;
+
+  if (n == 0) {
+    prevT = readBits(32);
+    temp.prev = readBits(32);
+    hum.prev = readBits(32);
+    out.t = prevT;
+    out.temp = bitsValue(temp.prev);
+    out.hum = bitsValue(hum.prev);
+    n = 1;
+    return true;
+  }
+
+  int32_t dod;
+  if (readBits(1) == 0) {
+    dod = 0;
+  } else if (readBits(1) == 0) {
+    dod = (int32_t)readBits(7) - 63;
+  } else if (readBits(1) == 0) {
+    dod = (int32_t)readBits(9) - 255;
+  } else if (readBits(1) == 0) {
+    dod = (int32_t)readBits(12) - 2047;
+  } else {
+    dod = (int32_t)readBits(32);
+  }
+  prevDelta += dod;
+  prevT += (uint32_t)prevDelta;
+
+  out.t = prevT;
+  out.temp = decodeValue(temp);
+  out.hum = decodeValue(hum);
+  n++;
+  return true;
+}
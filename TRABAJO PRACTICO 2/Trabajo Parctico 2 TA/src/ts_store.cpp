@@ -0,0 +1,187 @@
+#include "ts_store.h"
+
+#include <LittleFS.h>
+
+static const char* TS_FILE = "/ts.bin";
+static const uint32_t TS_BLOCK_MAGIC = 0x54534232; // "TSB2": valores en centesimas
+
+TsStore::TsStore()
+  : fsOk(false), nextSeq(0), lastT(0) {
+  memset(&stats, 0, sizeof(stats));
+  startBlock();
+}
+
+static size_t recordSize() {
+  return sizeof(uint32_t) * 4 + sizeof(uint16_t) * 2 + TsStore::BLOCK_BYTES;
+}
+
+void TsStore::startBlock() {
+  enc.reset(active, sizeof(active));
+}
+
+bool TsStore::readHeader(File& f, uint32_t slot, BlockHeader& h) {
+  if (!f.seek(slot * recordSize())) return false;
+  if (f.read((uint8_t*)&h, sizeof(h)) != sizeof(h)) return false;
+  return h.magic == TS_BLOCK_MAGIC && h.count > 0 && h.bits <= BLOCK_BYTES * 8;
+}
+
+bool TsStore::begin() {
+  if (!LittleFS.begin(true)) {
+    Serial.println("TsStore: LittleFS no disponible, historial solo en RAM");
+    return false;
+  }
+  fsOk = true;
+
+  File f = LittleFS.open(TS_FILE, "r");
+  if (!f) return true;
+
+  // El bloque con seq mas alto es el ultimo escrito
+  bool found = false;
+  uint32_t maxSeq = 0;
+  BlockHeader h;
+  for (uint32_t slot = 0; slot < MAX_FILE_BLOCKS; slot++) {
+    if (!readHeader(f, slot, h)) continue;
+    if (!found || h.seq > maxSeq) {
+      maxSeq = h.seq;
+      lastT = h.tLast;
+      found = true;
+    }
+  }
+  f.close();
+  if (found) nextSeq = maxSeq + 1;
+
+  Serial.printf("TsStore: %lu bloques en flash, ultimo t=%lu\n",
+                (unsigned long)(nextSeq < MAX_FILE_BLOCKS ? nextSeq : MAX_FILE_BLOCKS),
+                (unsigned long)lastT);
+  return true;
+}
+
+bool TsStore::writeBlock() {
+  if (enc.count() == 0) return true;
+  if (!fsOk) return false;
+
+  uint32_t c0 = ESP.getCycleCount();
+  File f = LittleFS.open(TS_FILE, LittleFS.exists(TS_FILE) ? "r+" : "w");
+  if (!f) return false;
+
+  BlockHeader h;
+  h.magic = TS_BLOCK_MAGIC;
+  h.seq = nextSeq;
+  h.t0 = enc.firstTime();
+  h.tLast = enc.lastTime();
+  h.count = enc.count();
+  h.bits = (uint16_t)enc.bitsUsed();
+
+  // Los slots se llenan en orden, el offset nunca supera el tamaño del archivo
+  uint32_t slot = nextSeq % MAX_FILE_BLOCKS;
+  bool ok = f.seek(slot * recordSize()) &&
+            f.write((const uint8_t*)&h, sizeof(h)) == sizeof(h) &&
+            f.write(active, BLOCK_BYTES) == BLOCK_BYTES;
+  f.close();
+  stats.flushCycles += ESP.getCycleCount() - c0;
+
+  if (ok) {
+    nextSeq++;
+    stats.blocksFlushed++;
+  } else {
+    stats.flushErrors++;
+  }
+  return ok;
+}
+
+void TsStore::append(uint32_t t, centi_t temp, centi_t hum) {
+  TsSample s = { t, temp, hum };
+
+  uint32_t c0 = ESP.getCycleCount();
+  uint32_t bits0 = enc.bitsUsed();
+  if (!enc.append(s)) {
+    // La escritura a LittleFS no es costo de codificacion: va a flushCycles
+    stats.encodeCycles += ESP.getCycleCount() - c0;
+    writeBlock();
+    c0 = ESP.getCycleCount();
+    startBlock();
+    bits0 = 0;
+    enc.append(s);
+  }
+  stats.encodeCycles += ESP.getCycleCount() - c0;
+  stats.compressedBits += enc.bitsUsed() - bits0;
+  stats.samples++;
+  lastT = t;
+}
+
+void TsStore::flush() {
+  if (writeBlock()) startBlock();
+}
+
+uint32_t TsStore::query(uint32_t from, uint32_t to, SampleCallback cb, void* ctx) {
+  uint32_t n = 0;
+  TsSample s;
+
+  if (fsOk) {
+    File f = LittleFS.open(TS_FILE, "r");
+    if (f) {
+      uint32_t first = nextSeq > MAX_FILE_BLOCKS ? nextSeq - MAX_FILE_BLOCKS : 0;
+      BlockHeader h;
+      for (uint32_t seq = first; seq < nextSeq; seq++) {
+        if (!readHeader(f, seq % MAX_FILE_BLOCKS, h) || h.seq != seq) continue;
+        if (h.tLast < from || h.t0 > to) continue;
+        if (f.read(scratch, BLOCK_BYTES) != BLOCK_BYTES) continue;
+
+        TsBlockDecoder dec(scratch, h.bits, h.count);
+        while (dec.next(s)) {
+          if (s.t < from) continue;
+          if (s.t > to) break;
+          n++;
+          if (!cb(s, ctx)) {
+            f.close();
+            return n;
+          }
+        }
+      }
+      f.close();
+    }
+  }
+
+  // Bloque activo en RAM
+  if (enc.count() > 0 && enc.lastTime() >= from && enc.firstTime() <= to) {
+    TsBlockDecoder dec(active, enc.bitsUsed(), enc.count());
+    while (dec.next(s)) {
+      if (s.t < from) continue;
+      if (s.t > to) break;
+      n++;
+      if (!cb(s, ctx)) break;
+    }
+  }
+  return n;
+}
+
+uint32_t TsStore::compressionRatio10(size_t rawBytes) const {
+  if (stats.compressedBits == 0) return 0;
+  return (uint32_t)((uint64_t)stats.samples * rawBytes * 8 * 10 / stats.compressedBits);
+}
+
+String TsStore::statsText() const {
+  char buf[288];
+  uint32_t cyclesPerSample = stats.samples ? (uint32_t)(stats.encodeCycles / stats.samples) : 0;
+  uint32_t writes = stats.blocksFlushed + stats.flushErrors;
+  uint32_t flushUs = writes ? (uint32_t)(stats.flushCycles / writes / ESP.getCpuFreqMHz()) : 0;
+  uint32_t bitsPerSample10 = stats.samples ? (uint32_t)(stats.compressedBits * 10 / stats.samples) : 0;
+  uint32_t ratio10 = compressionRatio10(sizeof(TsSample));
+  uint32_t floatRatio10 = compressionRatio10(sizeof(TsFloatSample));
+  snprintf(buf, sizeof(buf),
+           "Historial: %lu muestras, %lu bloques a flash (%lu errores)\n"
+           "Compresion: %lu.%lux (vs %u B/muestra), %lu.%lux (vs %u B float)\n"
+           "%lu.%lu bits/muestra\n"
+           "Codificacion: %lu ciclos/muestra (%lu us)\n"
+           "Escritura a flash: %lu us/bloque",
+           (unsigned long)stats.samples, (unsigned long)stats.blocksFlushed,
+           (unsigned long)stats.flushErrors,
+           (unsigned long)(ratio10 / 10), (unsigned long)(ratio10 % 10), (unsigned)sizeof(TsSample),
+           (unsigned long)(floatRatio10 / 10), (unsigned long)(floatRatio10 % 10),
+           (unsigned)sizeof(TsFloatSample),
+           (unsigned long)(bitsPerSample10 / 10), (unsigned long)(bitsPerSample10 % 10),
+           (unsigned long)cyclesPerSample,
+           (unsigned long)(cyclesPerSample / ESP.getCpuFreqMHz()),
+           (unsigned long)flushUs);
+  return String(buf);
+}
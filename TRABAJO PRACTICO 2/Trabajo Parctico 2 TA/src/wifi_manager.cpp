@@ -0,0 +1,216 @@
+#include "wifi_manager.h"
+
+#include <esp_attr.h>
+
+static const uint32_t RTC_CACHE_MAGIC = 0x57464333; // "WFC3" (hash del SSID, sin IP)
+
+// Tiempos (ms)
+static const unsigned long CONNECT_TIMEOUT_MS = 10000;
+static const unsigned long FAST_CONNECT_TIMEOUT_MS = 4000;
+static const unsigned long BACKOFF_MIN_MS = 500;
+static const unsigned long BACKOFF_MAX_MS = 60000;
+
+// RTC_NOINIT: no se reinicializa en resets por software, se valida con magic + checksum
+RTC_NOINIT_ATTR WifiManager::RtcCache WifiManager::rtcCache;
+
+WifiManager::WifiManager()
+  : ssid(nullptr), pass(nullptr), useStaticIp(false),
+    state(WIFI_IDLE), attemptIsFast(false), connectedFlag(false),
+    attemptStart(0), backoffMs(BACKOFF_MIN_MS), backoffUntil(0),
+    outageStart(0), everConnected(false),
+    evGotIp(false), evDisconnected(false) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+// --------------------- Cache RTC ---------------------
+uint32_t WifiManager::fnv1a(const uint8_t* p, size_t n, uint32_t h) {
+  for (size_t i = 0; i < n; i++) {
+    h ^= p[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+uint32_t WifiManager::cacheChecksum(const RtcCache& c) {
+  // FNV-1a sobre todo menos el checksum
+  return fnv1a(reinterpret_cast<const uint8_t*>(&c), offsetof(RtcCache, checksum));
+}
+
+uint32_t WifiManager::hashSsid(const char* ssid) {
+  return ssid ? fnv1a(reinterpret_cast<const uint8_t*>(ssid), strlen(ssid)) : 0;
+}
+
+// Un cache de otra red (reflasheo con otras credenciales) no se usa
+bool WifiManager::cacheValid() const {
+  return rtcCache.magic == RTC_CACHE_MAGIC &&
+         rtcCache.checksum == cacheChecksum(rtcCache) &&
+         rtcCache.ssidHash == hashSsid(ssid) &&
+         rtcCache.channel >= 1 && rtcCache.channel <= 14;
+}
+
+void WifiManager::cacheInvalidate() {
+  rtcCache.magic = 0;
+}
+
+void WifiManager::cacheStore() {
+  const uint8_t* bssid = WiFi.BSSID();
+  if (bssid == nullptr) return;
+  rtcCache.ssidHash = hashSsid(ssid);
+  memcpy(rtcCache.bssid, bssid, 6);
+  rtcCache.channel = (uint8_t)WiFi.channel();
+  rtcCache.magic = RTC_CACHE_MAGIC;
+  rtcCache.checksum = cacheChecksum(rtcCache);
+}
+
+// --------------------- API ---------------------
+void WifiManager::setStaticIP(IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns) {
+  staticIp = ip;
+  staticGw = gateway;
+  staticMask = subnet;
+  staticDns = dns;
+  useStaticIp = true;
+}
+
+void WifiManager::begin(const char* ssid_, const char* pass_) {
+  ssid = ssid_;
+  pass = pass_;
+
+  // La reconexion la maneja esta clase, no el driver
+  WiFi.persistent(false);
+  WiFi.setAutoReconnect(false);
+  WiFi.mode(WIFI_STA);
+  WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t) { onEvent(event); });
+
+  startAttempt();
+}
+
+void WifiManager::onEvent(arduino_event_id_t event) {
+  // Corre en la tarea de eventos: solo marcar flags
+  if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+    evGotIp = true;
+  } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+    evDisconnected = true;
+  }
+}
+
+void WifiManager::startAttempt() {
+  attemptIsFast = cacheValid();
+  stats.attempts++;
+  evGotIp = false;
+  evDisconnected = false;
+
+  // Con DHCP no se fija nada: una IP de un arranque anterior puede haber
+  // vencido y estar asignada a otro equipo
+  if (useStaticIp) WiFi.config(staticIp, staticGw, staticMask, staticDns);
+
+  if (attemptIsFast) {
+    // Sin escaneo: directo al AP y canal conocidos
+    WiFi.begin(ssid, pass, rtcCache.channel, rtcCache.bssid, true);
+  } else {
+    WiFi.begin(ssid, pass);
+  }
+
+  attemptStart = millis();
+  state = WIFI_CONNECTING;
+}
+
+bool WifiManager::justConnected() {
+  bool v = connectedFlag;
+  connectedFlag = false;
+  return v;
+}
+
+unsigned long WifiManager::currentOutageMs() const {
+  if (state == WIFI_CONNECTED || !everConnected) return 0;
+  return millis() - outageStart;
+}
+
+void WifiManager::loop() {
+  unsigned long now = millis();
+
+  switch (state) {
+    case WIFI_IDLE:
+      break;
+
+    case WIFI_CONNECTING: {
+      if (evGotIp) {
+        evGotIp = false;
+        uint32_t elapsed = now - attemptStart;
+        stats.connects++;
+        if (attemptIsFast) stats.fastConnects++;
+        stats.lastConnectMs = elapsed;
+        if (stats.minConnectMs == 0 || elapsed < stats.minConnectMs) stats.minConnectMs = elapsed;
+        if (elapsed > stats.maxConnectMs) stats.maxConnectMs = elapsed;
+
+        if (everConnected) {
+          uint32_t outage = now - outageStart;
+          stats.lastOutageMs = outage;
+          stats.totalOutageMs += outage;
+          if (outage > stats.longestOutageMs) stats.longestOutageMs = outage;
+        }
+        everConnected = true;
+
+        cacheStore();
+        backoffMs = BACKOFF_MIN_MS;
+        state = WIFI_CONNECTED;
+        connectedFlag = true;
+
+        Serial.printf("WiFi connected in %lu ms (%s), IP: %s\n",
+                      (unsigned long)elapsed, attemptIsFast ? "fast" : "scan",
+                      WiFi.localIP().toString().c_str());
+        break;
+      }
+
+      unsigned long timeout = attemptIsFast ? FAST_CONNECT_TIMEOUT_MS : CONNECT_TIMEOUT_MS;
+      if (evDisconnected || now - attemptStart >= timeout) {
+        evDisconnected = false;
+        // El AP cacheado pudo cambiar de canal: el proximo intento escanea
+        if (attemptIsFast) cacheInvalidate();
+        WiFi.disconnect(false);
+        backoffUntil = now + backoffMs;
+        Serial.printf("WiFi attempt failed, retry in %lu ms\n", backoffMs);
+        backoffMs *= 2;
+        if (backoffMs > BACKOFF_MAX_MS) backoffMs = BACKOFF_MAX_MS;
+        state = WIFI_BACKOFF;
+      }
+      break;
+    }
+
+    case WIFI_CONNECTED:
+      if (evDisconnected || WiFi.status() != WL_CONNECTED) {
+        evDisconnected = false;
+        stats.outages++;
+        outageStart = now;
+        Serial.println("WiFi lost, reconnecting");
+        // Primer reintento inmediato con el AP cacheado
+        startAttempt();
+      }
+      break;
+
+    case WIFI_BACKOFF:
+      if ((long)(now - backoffUntil) >= 0) startAttempt();
+      break;
+  }
+}
+
+// --------------------- Reporte ---------------------
+String WifiManager::statsText() const {
+  char buf[256];
+  snprintf(buf, sizeof(buf),
+           "WiFi: %s\n"
+           "Conexiones: %lu (rapidas %lu) / intentos %lu\n"
+           "T. conexion: ult %lu ms, min %lu, max %lu\n"
+           "Cortes: %lu, ult %lu ms, max %lu ms, total %lu ms",
+           state == WIFI_CONNECTED ? "conectado" : "desconectado",
+           (unsigned long)stats.connects, (unsigned long)stats.fastConnects,
+           (unsigned long)stats.attempts,
+           (unsigned long)stats.lastConnectMs, (unsigned long)stats.minConnectMs,
+           (unsigned long)stats.maxConnectMs,
+           (unsigned long)stats.outages, (unsigned long)stats.lastOutageMs,
+           (unsigned long)stats.longestOutageMs, (unsigned long)stats.totalOutageMs);
+  return String(buf);
+}
+
+void WifiManager::printStats(Print& out) const {
+  out.println(statsText());
+}
@@ -0,0 +1,253 @@
+/* Tests nativos de alerts.cpp (pio test -e native)
+   - La tabla ordenada por umbral se compara contra un recorrido lineal de
+     todas las reglas con muestras al azar
+   - Histeresis y cola de avisos llena
+*/
+#include <Arduino.h>
+#include <unity.h>
+
+#include <map>
+#include <vector>
+
+#include "alerts.h"
+
+// La misma histeresis que alerts.cpp
+static const int32_t HYST[2] = { 50, 200 };
+
+// Mensajes enviados por flush()
+static std::vector<std::string> sent;
+
+static bool capture(const char* chatId, const String& text, void*) {
+  sent.push_back(std::string(chatId) + "|" + text.c_str());
+  return true;
+}
+
+static int countLines(const char* what) {
+  int n = 0;
+  for (const std::string& m : sent) {
+    for (size_t i = m.find(what); i != std::string::npos; i = m.find(what, i + 1)) n++;
+  }
+  return n;
+}
+
+void setUp() { sent.clear(); }
+void tearDown() {}
+
+// --------------------- Modelo de referencia ---------------------
+// Cada muestra evalua todas las reglas
+struct RefRule {
+  int64_t chat;
+  AlertEngine::Spec spec;
+  int state;                 // 0 normal, 1 esperando, 2 activa
+  uint32_t since;
+};
+
+struct RefEngine {
+  std::map<int, RefRule> rules;
+  centi_t last[2] = { CENTI_NAN, CENTI_NAN };
+  uint32_t fired = 0, cleared = 0;
+
+  void evaluate(RefRule& r, centi_t v, uint32_t now) {
+    int32_t th = r.spec.threshold;
+    int32_t hyst = HYST[r.spec.sensor];
+    bool above = r.spec.op == AlertEngine::ALERT_ABOVE;
+    bool cond = above ? v > th : v < th;
+    bool normal = above ? v < th - hyst : v > th + hyst;
+    if (r.state == 0 && cond) {
+      if (r.spec.holdS == 0) {
+        r.state = 2;
+        fired++;
+      } else {
+        r.state = 1;
+        r.since = now;
+      }
+    } else if (r.state == 1) {
+      if (!cond) r.state = 0;
+      else if (now - r.since >= r.spec.holdS) {
+        r.state = 2;
+        fired++;
+      }
+    } else if (r.state == 2 && normal) {
+      r.state = 0;
+      cleared++;
+    }
+  }
+
+  void add(int id, int64_t chat, const AlertEngine::Spec& spec, uint32_t now) {
+    RefRule r = { chat, spec, 0, now };
+    if (centiValid(last[spec.sensor])) evaluate(r, last[spec.sensor], now);
+    rules[id] = r;
+  }
+
+  void sample(uint32_t now, centi_t t, centi_t h) {
+    last[0] = t;
+    last[1] = h;
+    for (auto& kv : rules) evaluate(kv.second, last[kv.second.spec.sensor], now);
+  }
+
+  void tick(uint32_t now) {
+    for (auto& kv : rules) {
+      RefRule& r = kv.second;
+      if (r.state == 1 && now - r.since >= r.spec.holdS) {
+        r.state = 2;
+        fired++;
+      }
+    }
+  }
+};
+
+// Estado de cada regla segun list(): id -> 0 / 1 / 2
+static void listStates(const AlertEngine& e, int64_t chat, std::map<int, int>& out) {
+  std::string text = e.list(chat).c_str();
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t end = text.find('\n', pos);
+    std::string line = text.substr(pos, end - pos);
+    int id = atoi(line.c_str() + 1);
+    int state = 0;
+    if (line.find("(activa)") != std::string::npos) state = 2;
+    else if (line.find("(esperando)") != std::string::npos) state = 1;
+    out[id] = state;
+    pos = end + 1;
+  }
+}
+
+// LCG fijo: la secuencia es la misma en cada corrida
+static uint32_t rngState = 12345;
+static uint32_t rnd(uint32_t n) {
+  rngState = rngState * 1103515245u + 12345u;
+  return (rngState >> 8) % n;
+}
+
+static void test_table_matches_linear_scan() {
+  static AlertEngine engine;
+  RefEngine ref;
+  const int CHATS = 8;
+  uint32_t now = 0;
+
+  for (int i = 0; i < 120; i++) {
+    AlertEngine::Spec spec;
+    spec.sensor = rnd(2);
+    spec.op = rnd(2);
+    spec.threshold = spec.sensor == AlertEngine::ALERT_TEMP ? 1500 + rnd(2000) : 3000 + rnd(5000);
+    spec.holdS = rnd(3) == 0 ? 10 * (1 + rnd(6)) : 0;
+    int64_t chat = 1000 + i % CHATS;
+    int id = engine.add(chat, spec, now);
+    TEST_ASSERT_GREATER_THAN(0, id);
+    ref.add(id, chat, spec, now);
+  }
+
+  centi_t t = 2500, h = 5500;
+  for (int step = 0; step < 3000; step++) {
+    now += 1 + rnd(10);
+    // Pasos chicos y algun salto grande
+    if (rnd(20) == 0) {
+      t = 1400 + rnd(2200);
+      h = 2800 + rnd(5400);
+    } else {
+      t = max<int32_t>(1400, min<int32_t>(3600, t + (int32_t)rnd(121) - 60));
+      h = max<int32_t>(2800, min<int32_t>(8200, h + (int32_t)rnd(301) - 150));
+    }
+    engine.sample(now, t, h);
+    engine.tick(now);
+    ref.sample(now, t, h);
+    ref.tick(now);
+    engine.flush(capture, nullptr);
+
+    TEST_ASSERT_EQUAL(ref.fired, engine.getStats().fired);
+    TEST_ASSERT_EQUAL(ref.cleared, engine.getStats().cleared);
+  }
+
+  std::map<int, int> states;
+  for (int c = 0; c < CHATS; c++) listStates(engine, 1000 + c, states);
+  TEST_ASSERT_EQUAL(ref.rules.size(), states.size());
+  for (auto& kv : ref.rules) TEST_ASSERT_EQUAL(kv.second.state, states[kv.first]);
+  // Con muestras chicas se evalua mucho menos que el recorrido lineal
+  TEST_ASSERT_LESS_THAN(3000u * 120 / 4, engine.getStats().evaluated);
+}
+
+// --------------------- Histeresis ---------------------
+static void test_hysteresis_rearm() {
+  static AlertEngine engine;
+  AlertEngine::Spec spec;
+  TEST_ASSERT_TRUE(AlertEngine::parse("temp>30", spec));
+  engine.add(1, spec, 0);
+
+  engine.sample(1, 3010, 5000);
+  TEST_ASSERT_EQUAL(1, engine.getStats().fired);
+  // Debajo del umbral pero dentro de la histeresis: sigue activa
+  engine.sample(2, 2960, 5000);
+  engine.sample(3, 3100, 5000);
+  TEST_ASSERT_EQUAL(1, engine.getStats().fired);
+  TEST_ASSERT_EQUAL(0, engine.getStats().cleared);
+  // Debajo de umbral - 0.5: vuelve a normal y se rearma
+  engine.sample(4, 2940, 5000);
+  TEST_ASSERT_EQUAL(1, engine.getStats().cleared);
+  engine.sample(5, 3001, 5000);
+  TEST_ASSERT_EQUAL(2, engine.getStats().fired);
+
+  engine.flush(capture, nullptr);
+  TEST_ASSERT_EQUAL(1, (int)sent.size());
+  TEST_ASSERT_EQUAL(2, countLines(": ALERTA"));
+  TEST_ASSERT_EQUAL(1, countLines(": normal"));
+}
+
+// --------------------- Cola llena ---------------------
+// 40 reglas que disparan con la misma muestra: 32 entran en la cola y el
+// resto queda pendiente para el flush siguiente
+static void addMany(AlertEngine& engine, int n) {
+  AlertEngine::Spec spec;
+  TEST_ASSERT_TRUE(AlertEngine::parse("temp>20", spec));
+  for (int i = 0; i < n; i++) {
+    spec.threshold = 2000 + i;
+    TEST_ASSERT_GREATER_THAN(0, engine.add(1 + i / AlertEngine::MAX_PER_CHAT, spec, 0));
+  }
+}
+
+static void test_queue_full_resends() {
+  static AlertEngine engine;
+  const int N = 40;
+  addMany(engine, N);
+
+  engine.sample(1, 2500, 5000);
+  TEST_ASSERT_EQUAL(N, engine.getStats().fired);
+  TEST_ASSERT_EQUAL(N - AlertEngine::EVENT_QUEUE, engine.getStats().deferred);
+
+  engine.flush(capture, nullptr);
+  TEST_ASSERT_EQUAL(AlertEngine::EVENT_QUEUE, countLines(": ALERTA"));
+  engine.flush(capture, nullptr);
+  TEST_ASSERT_EQUAL(N, countLines(": ALERTA"));
+  TEST_ASSERT_EQUAL(0, engine.getStats().dropped);
+
+  // Nada queda pendiente
+  engine.flush(capture, nullptr);
+  TEST_ASSERT_EQUAL(N, countLines(": ALERTA"));
+}
+
+static void test_queue_full_cancelled_notice() {
+  static AlertEngine engine;
+  const int N = 40;
+  addMany(engine, N);
+
+  engine.sample(1, 2500, 5000);
+  // Vuelven a normal antes de avisar: las demoradas no tienen nada que decir
+  engine.sample(2, 1000, 5000);
+  TEST_ASSERT_EQUAL(N, engine.getStats().cleared);
+
+  engine.flush(capture, nullptr);
+  engine.flush(capture, nullptr);
+  engine.flush(capture, nullptr);
+  int alerts = countLines(": ALERTA");
+  TEST_ASSERT_EQUAL(AlertEngine::EVENT_QUEUE, alerts);
+  // Cada regla avisada como ALERTA recibe su normal; ninguna otra
+  TEST_ASSERT_EQUAL(alerts, countLines(": normal"));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_table_matches_linear_scan);
+  RUN_TEST(test_hysteresis_rearm);
+  RUN_TEST(test_queue_full_resends);
+  RUN_TEST(test_queue_full_cancelled_notice);
+  return UNITY_END();
+}
@@ -0,0 +1,146 @@
+/* Tests nativos de chart.cpp (pio test -e native)
+   - PNG chico con bytes conocidos (valores calculados con zlib de Python)
+   - Grafico completo verificado contra CRC-32 / Adler-32 bit a bit
+*/
+#include <unity.h>
+
+#include <string.h>
+
+#include <vector>
+
+#include "chart.h"
+
+void setUp() {}
+void tearDown() {}
+
+static std::vector<uint8_t> streamAll(PngRowStream& png) {
+  std::vector<uint8_t> out;
+  while (png.advance()) out.insert(out.end(), png.data(), png.data() + png.length());
+  return out;
+}
+
+static uint32_t be32(const std::vector<uint8_t>& b, size_t at) {
+  return (uint32_t)b[at] << 24 | (uint32_t)b[at + 1] << 16 | (uint32_t)b[at + 2] << 8 | b[at + 3];
+}
+
+// Referencias sin tabla, independientes de las de chart.cpp
+static uint32_t refCrc32(const uint8_t* p, size_t n) {
+  uint32_t crc = 0xFFFFFFFF;
+  while (n--) {
+    crc ^= *p++;
+    for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+  }
+  return crc ^ 0xFFFFFFFF;
+}
+
+static uint32_t refAdler32(const std::vector<uint8_t>& raw) {
+  uint32_t a = 1, b = 0;
+  for (uint8_t c : raw) {
+    a = (a + c) % 65521;
+    b = (b + a) % 65521;
+  }
+  return b << 16 | a;
+}
+
+// --------------------- PNG 8x2 ---------------------
+static void smallRows(int y, uint8_t* row, void*) {
+  row[0] = y == 0 ? 0xA5 : 0x3C;
+}
+
+static void test_png_small_known_bytes() {
+  PngRowStream png(8, 2, smallRows, nullptr);
+  std::vector<uint8_t> b = streamAll(png);
+
+  TEST_ASSERT_EQUAL(77, png.size());
+  TEST_ASSERT_EQUAL(77, b.size());
+
+  static const uint8_t SIG[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  TEST_ASSERT_EQUAL(0, memcmp(b.data(), SIG, 8));
+
+  // IHDR
+  TEST_ASSERT_EQUAL(13, be32(b, 8));
+  TEST_ASSERT_EQUAL(0, memcmp(&b[12], "IHDR", 4));
+  TEST_ASSERT_EQUAL_HEX32(0x4DEFA040, be32(b, 29));
+
+  // IDAT: zlib 78 01, dos bloques stored de 2 bytes y Adler-32
+  TEST_ASSERT_EQUAL(20, be32(b, 33));
+  TEST_ASSERT_EQUAL(0, memcmp(&b[37], "IDAT", 4));
+  static const uint8_t ZLIB[16] = { 0x78, 0x01,
+                                    0x00, 0x02, 0x00, 0xFD, 0xFF, 0x00, 0xA5,
+                                    0x01, 0x02, 0x00, 0xFD, 0xFF, 0x00, 0x3C };
+  TEST_ASSERT_EQUAL(0, memcmp(&b[41], ZLIB, sizeof(ZLIB)));
+  TEST_ASSERT_EQUAL_HEX32(0x022F00E2, be32(b, 57));
+  TEST_ASSERT_EQUAL_HEX32(0x1918788A, be32(b, 61));
+
+  // IEND
+  TEST_ASSERT_EQUAL(0, be32(b, 65));
+  TEST_ASSERT_EQUAL(0, memcmp(&b[69], "IEND", 4));
+  TEST_ASSERT_EQUAL_HEX32(0xAE426082, be32(b, 73));
+
+  // Terminado: no hay mas tramos
+  TEST_ASSERT_FALSE(png.advance());
+}
+
+// --------------------- Grafico completo ---------------------
+static ChartImage chart;
+
+static void chartRows(int y, uint8_t* row, void*) {
+  chart.renderRow(y, row);
+}
+
+static void test_png_chart_checksums() {
+  chart.clear();
+  for (int x = 0; x < ChartImage::WIDTH; x += 3) {
+    chart.addPoint(x, (uint8_t)(x % ChartImage::PANEL_H), (uint8_t)((x * 7) % ChartImage::PANEL_H));
+  }
+  chart.connect();
+
+  PngRowStream png(ChartImage::WIDTH, ChartImage::HEIGHT, chartRows, nullptr);
+  std::vector<uint8_t> b = streamAll(png);
+  TEST_ASSERT_EQUAL(png.size(), b.size());
+
+  // Cada chunk: largo + tipo + datos + CRC sobre tipo y datos
+  size_t at = 8;
+  const char* types[3] = { "IHDR", "IDAT", "IEND" };
+  size_t idat = 0, idatLen = 0;
+  for (int c = 0; c < 3; c++) {
+    uint32_t n = be32(b, at);
+    TEST_ASSERT_EQUAL(0, memcmp(&b[at + 4], types[c], 4));
+    TEST_ASSERT_EQUAL_HEX32(refCrc32(&b[at + 4], n + 4), be32(b, at + 8 + n));
+    if (c == 1) {
+      idat = at + 8;
+      idatLen = n;
+    }
+    at += 12 + n;
+  }
+  TEST_ASSERT_EQUAL(b.size(), at);
+
+  // zlib: bloques stored uno por fila, el ultimo con BFINAL
+  TEST_ASSERT_EQUAL_HEX8(0x78, b[idat]);
+  TEST_ASSERT_EQUAL_HEX8(0x01, b[idat + 1]);
+  std::vector<uint8_t> raw;
+  size_t p = idat + 2;
+  uint8_t row[ChartImage::ROW_BYTES];
+  for (int y = 0; y < ChartImage::HEIGHT; y++) {
+    TEST_ASSERT_EQUAL(y == ChartImage::HEIGHT - 1 ? 1 : 0, b[p]);
+    uint16_t n = b[p + 1] | b[p + 2] << 8;
+    uint16_t nn = b[p + 3] | b[p + 4] << 8;
+    TEST_ASSERT_EQUAL(ChartImage::ROW_BYTES + 1, n);
+    TEST_ASSERT_EQUAL(0xFFFF, n ^ nn);
+    // Filtro 0 y la fila tal cual la dibuja ChartImage
+    TEST_ASSERT_EQUAL(0, b[p + 5]);
+    chart.renderRow(y, row);
+    TEST_ASSERT_EQUAL(0, memcmp(&b[p + 6], row, ChartImage::ROW_BYTES));
+    raw.insert(raw.end(), &b[p + 5], &b[p + 5] + n);
+    p += 5 + n;
+  }
+  TEST_ASSERT_EQUAL_HEX32(refAdler32(raw), be32(b, p));
+  TEST_ASSERT_EQUAL(idat + idatLen, p + 4);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_png_small_known_bytes);
+  RUN_TEST(test_png_chart_checksums);
+  return UNITY_END();
+}
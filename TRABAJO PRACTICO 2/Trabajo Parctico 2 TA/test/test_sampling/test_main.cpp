@@ -0,0 +1,122 @@
+/* Tests nativos de sampling.cpp (pio test -e native) */
+#include <Arduino.h>
+#include <unity.h>
+
+#include "sampling.h"
+
+// Misma configuracion que DHT_SAMPLING en main.cpp
+static const AdaptiveSampler::Config CFG = {
+  2000, 30000,
+  50, 200,
+  20, 50
+};
+
+void setUp() {}
+void tearDown() {}
+
+// --------------------- AdaptiveSampler ---------------------
+// Toma muestras cuando vencen; devuelve el 'now' de la ultima
+static unsigned long feed(AdaptiveSampler& s, unsigned long now, int n,
+                          centi_t temp, centi_t hum, centi_t noise) {
+  for (int i = 0; i < n; i++) {
+    now += s.intervalMs();
+    TEST_ASSERT_TRUE(s.due(now));
+    centi_t d = (i % 2) ? noise : -noise;
+    s.update(now, temp + d, hum - d);
+  }
+  return now;
+}
+
+static void test_sampler_backs_off_on_lsb_noise() {
+  AdaptiveSampler s(CFG);
+  s.update(0, 2500, 6000);
+  // +-1 LSB del DHT22 (0.1 C / 0.1 %) no es un cambio rapido
+  feed(s, 0, 10, 2500, 6000, 10);
+  TEST_ASSERT_EQUAL(CFG.maxIntervalMs, s.intervalMs());
+  TEST_ASSERT_EQUAL(0, s.getStats().speedUps);
+}
+
+static void test_sampler_speeds_up_on_real_change() {
+  AdaptiveSampler s(CFG);
+  s.update(0, 2500, 6000);
+  unsigned long now = feed(s, 0, 10, 2500, 6000, 0);
+  TEST_ASSERT_EQUAL(CFG.maxIntervalMs, s.intervalMs());
+
+  // 0.5 C en 30 s = 1 C/min
+  now += s.intervalMs();
+  s.update(now, 2550, 6000);
+  TEST_ASSERT_EQUAL(CFG.minIntervalMs, s.intervalMs());
+  TEST_ASSERT_EQUAL(1, s.getStats().speedUps);
+
+  // Humedad: 3 % en 30 s tambien
+  now = feed(s, now, 10, 2550, 6000, 0);
+  now += s.intervalMs();
+  s.update(now, 2550, 6300);
+  TEST_ASSERT_EQUAL(CFG.minIntervalMs, s.intervalMs());
+}
+
+static void test_sampler_small_fast_change() {
+  AdaptiveSampler s(CFG);
+  s.update(0, 2500, 6000);
+  unsigned long now = feed(s, 0, 10, 2500, 6000, 0);
+  // 0.3 C en 30 s = 0.6 C/min: supera lo estable y es rapido
+  now += s.intervalMs();
+  s.update(now, 2530, 6000);
+  TEST_ASSERT_EQUAL(CFG.minIntervalMs, s.intervalMs());
+  // 0.3 C cada 2 s sigue siendo rapido: el intervalo no crece
+  now += s.intervalMs();
+  s.update(now, 2560, 6000);
+  TEST_ASSERT_EQUAL(CFG.minIntervalMs, s.intervalMs());
+}
+
+static void test_sampler_error_retries_at_min() {
+  AdaptiveSampler s(CFG);
+  s.update(0, 2500, 6000);
+  unsigned long now = feed(s, 0, 10, 2500, 6000, 0);
+  s.error(now);
+  TEST_ASSERT_EQUAL(CFG.minIntervalMs, s.intervalMs());
+  TEST_ASSERT_FALSE(s.due(now + CFG.minIntervalMs - 1));
+  TEST_ASSERT_TRUE(s.due(now + CFG.minIntervalMs));
+  TEST_ASSERT_EQUAL(1, s.getStats().errors);
+}
+
+// --------------------- DeadbandPublisher ---------------------
+static void test_publisher_deadband() {
+  DeadbandPublisher p(30, 100, 600000);
+  TEST_ASSERT_EQUAL(DeadbandPublisher::FIRST, p.offer(0, 2500, 6000));
+  p.published(0, 2500, 6000, DeadbandPublisher::FIRST);
+
+  TEST_ASSERT_EQUAL(DeadbandPublisher::SKIP, p.offer(2000, 2530, 6100));
+  TEST_ASSERT_EQUAL(DeadbandPublisher::CHANGE, p.offer(4000, 2531, 6000));
+  TEST_ASSERT_EQUAL(DeadbandPublisher::CHANGE, p.offer(6000, 2500, 5899));
+  TEST_ASSERT_EQUAL(DeadbandPublisher::SILENCE, p.offer(600000, 2500, 6000));
+  p.published(600000, 2500, 6000, DeadbandPublisher::SILENCE);
+
+  TEST_ASSERT_EQUAL(5, p.getStats().offered);
+  TEST_ASSERT_EQUAL(2, p.getStats().published);
+  TEST_ASSERT_EQUAL(1, p.getStats().bySilence);
+}
+
+static void test_publisher_manual_after_skipped_silence() {
+  DeadbandPublisher p(30, 100, 600000);
+  p.published(0, 2500, 6000, DeadbandPublisher::FIRST);
+  // Vence el silencio pero el envio automatico no se hace (sin WiFi)
+  TEST_ASSERT_EQUAL(DeadbandPublisher::SILENCE, p.offer(600000, 2500, 6000));
+  // Un /platiot posterior no cuenta como publicacion por silencio
+  p.published(601000, 2500, 6000, DeadbandPublisher::MANUAL);
+  TEST_ASSERT_EQUAL(2, p.getStats().published);
+  TEST_ASSERT_EQUAL(0, p.getStats().bySilence);
+  // Y reinicia la banda y el silencio
+  TEST_ASSERT_EQUAL(DeadbandPublisher::SKIP, p.offer(603000, 2500, 6000));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_sampler_backs_off_on_lsb_noise);
+  RUN_TEST(test_sampler_speeds_up_on_real_change);
+  RUN_TEST(test_sampler_small_fast_change);
+  RUN_TEST(test_sampler_error_retries_at_min);
+  RUN_TEST(test_publisher_deadband);
+  RUN_TEST(test_publisher_manual_after_skipped_silence);
+  return UNITY_END();
+}
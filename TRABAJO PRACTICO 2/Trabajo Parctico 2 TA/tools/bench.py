@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+"""Benchmark de punta a punta del bot de TP2 contra servidores simulados.
+
+1. Compilar y grabar el firmware con el entorno que redirige a la PC:
+       pio run -e esp32dev_mock -t upload
+   (ajustar MOCK_API_HOST en platformio.ini con la IP de esta PC)
+2. Correr el benchmark:
+       python3 tools/bench.py --bursts 5 --burst-size 10 --out results.json
+3. Usarlo como regresion contra una corrida anterior:
+       python3 tools/bench.py --baseline results.json --tolerance 0.2
+
+Cada comando se inyecta con un chat_id propio, asi la respuesta del bot se
+empareja sin ambiguedad. Al final se envia /mem para leer el minimo de heap.
+
+Ruido: el bot se mide por WiFi real, asi que la latencia depende del RF y
+del AP. Por eso la medicion se repite --runs veces (default 5, minimo 3 para
+comparar) y la regresion compara la mediana de p50, p95 y throughput de
+las corridas. Para cada metrica se informa la dispersion entre corridas,
+(max - min) / mediana; la comparacion solo vale si la dispersion de ambas
+mediciones es menor que --tolerance. Si no lo es, se agregan corridas o
+rafagas, o se mide con el AP cerca y sin otro trafico, antes de comparar.
+
+Codigos de salida: 0 sin regresiones, 1 timeouts o alguna mediana peor que
+la tolerancia, 2 sin dispositivo o medicion demasiado ruidosa para decidir.
+"""
+
+import argparse
+import json
+import re
+import sys
+import time
+
+from mock_servers import MockServers
+
+DEFAULT_COMMANDS = "/dht22,/led23on,/led23off,/pote,/platiot,/displaydht"
+GATED = ("p50_ms", "p95_ms", "throughput_cmd_s")
+MIN_RUNS = 3
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    s = sorted(values)
+    k = (len(s) - 1) * p / 100.0
+    lo = int(k)
+    hi = min(lo + 1, len(s) - 1)
+    return s[lo] + (s[hi] - s[lo]) * (k - lo)
+
+
+def wait_reply(state, chat_id, since_index, deadline):
+    """Devuelve (instante, texto) de la primera respuesta a chat_id."""
+    chat_id = str(chat_id)
+    with state.lock:
+        idx = since_index
+        while True:
+            while idx < len(state.replies):
+                t, chat, text = state.replies[idx]
+                idx += 1
+                if chat == chat_id:
+                    return t, text
+            left = deadline - time.monotonic()
+            if left <= 0:
+                return None, None
+            state.lock.wait(left)
+
+
+def wait_device(state, timeout):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        with state.lock:
+            if state.polls > 0:
+                return True
+        time.sleep(0.2)
+    return False
+
+
+def summary(values):
+    return {"n": len(values),
+            "p50_ms": round(percentile(values, 50), 1),
+            "p95_ms": round(percentile(values, 95), 1),
+            "p99_ms": round(percentile(values, 99), 1),
+            "max_ms": round(max(values), 1) if values else 0.0}
+
+
+def median(values):
+    return percentile(values, 50)
+
+
+def spread(values):
+    """Dispersion relativa entre corridas: (max - min) / mediana."""
+    m = median(values)
+    return round((max(values) - min(values)) / m, 3) if values and m > 0 else 0.0
+
+
+def measure(state, args, commands, latencies, chat_seq):
+    """Una corrida de rafagas; devuelve (resumen, timeouts, chat_seq)."""
+    run_lat = []
+    timeouts = 0
+    t_start = time.monotonic()
+    answered = 0
+
+    for b in range(args.bursts):
+        burst = []
+        reply_base = len(state.replies)
+        for i in range(args.burst_size):
+            cmd = commands[(b * args.burst_size + i) % len(commands)]
+            chat_seq += 1
+            _, t0 = state.inject(cmd, chat_seq)
+            burst.append((cmd, chat_seq, t0))
+
+        deadline = time.monotonic() + args.reply_timeout
+        got = 0
+        for cmd, chat, t0 in burst:
+            t1, _ = wait_reply(state, chat, reply_base, deadline)
+            if t1 is None:
+                timeouts += 1
+                continue
+            ms = (t1 - t0) * 1000.0
+            latencies.setdefault(cmd, []).append(ms)
+            run_lat.append(ms)
+            answered += 1
+            got += 1
+        print("Rafaga %d/%d: %d/%d respuestas" % (b + 1, args.bursts, got, len(burst)))
+        time.sleep(args.pause)
+
+    elapsed = time.monotonic() - t_start
+    res = summary(run_lat)
+    res["throughput_cmd_s"] = round(answered / elapsed, 3) if elapsed > 0 else 0.0
+    return res, timeouts, chat_seq
+
+
+def run(args):
+    servers = MockServers(args.host, args.telegram_port, args.thingspeak_port,
+                          tls=not args.no_tls).start()
+    state = servers.state
+    commands = [c.strip() for c in args.commands.split(",") if c.strip()]
+
+    print("Esperando al dispositivo (primer getUpdates)...")
+    if not wait_device(state, args.wait_device):
+        print("ERROR: el dispositivo no consulto getUpdates en %.0f s" % args.wait_device)
+        servers.stop()
+        return None
+
+    latencies = {}
+    runs = []
+    timeouts = 0
+    chat_seq = 100000
+    for r in range(args.runs):
+        print("Corrida %d/%d" % (r + 1, args.runs))
+        res, lost, chat_seq = measure(state, args, commands, latencies, chat_seq)
+        runs.append(res)
+        timeouts += lost
+
+    # Maximo de memoria usada (heap total - minimo libre)
+    mem = {}
+    chat_seq += 1
+    reply_base = len(state.replies)
+    state.inject("/mem", chat_seq)
+    _, text = wait_reply(state, chat_seq, reply_base, time.monotonic() + args.reply_timeout)
+    if text:
+        for key, label in (("free", "Heap libre"), ("min_free", "Heap minimo"),
+                           ("max_block", "Bloque max"), ("total", "Heap total")):
+            m = re.search(label + r":\s*(\d+)", text)
+            if m:
+                mem[key] = int(m.group(1))
+        if "total" in mem and "min_free" in mem:
+            mem["high_water"] = mem["total"] - mem["min_free"]
+
+    servers.stop()
+
+    all_lat = [ms for v in latencies.values() for ms in v]
+    return {
+        "commands": {cmd: summary(v) for cmd, v in sorted(latencies.items())},
+        "overall": summary(all_lat),
+        "throughput_cmd_s": round(median([r["throughput_cmd_s"] for r in runs]), 3),
+        "runs": runs,
+        "median": {k: round(median([r[k] for r in runs]), 3) for k in GATED},
+        "spread": {k: spread([r[k] for r in runs]) for k in GATED},
+        "timeouts": timeouts,
+        "thingspeak_writes": len(state.thingspeak_writes),
+        "memory": mem,
+    }
+
+
+def print_report(res):
+    print()
+    print("%-14s %5s %9s %9s %9s %9s" % ("comando", "n", "p50 ms", "p95 ms", "p99 ms", "max ms"))
+    rows = list(res["commands"].items()) + [("TOTAL", res["overall"])]
+    for cmd, s in rows:
+        print("%-14s %5d %9.1f %9.1f %9.1f %9.1f" %
+              (cmd, s["n"], s["p50_ms"], s["p95_ms"], s["p99_ms"], s["max_ms"]))
+    print()
+    print("Throughput: %.2f comandos/s (mediana), timeouts: %d" % (res["throughput_cmd_s"], res["timeouts"]))
+    print("Corridas: %d, mediana / dispersion: %s" % (len(res["runs"]), ", ".join(
+        "%s %.1f / %.0f%%" % (k, res["median"][k], res["spread"][k] * 100) for k in GATED)))
+    mem = res["memory"]
+    if "high_water" in mem:
+        print("Heap: maximo usado %d B, minimo libre %d B, bloque max %d B" %
+              (mem["high_water"], mem["min_free"], mem.get("max_block", 0)))
+    else:
+        print("Heap: sin datos (/mem no respondio)")
+
+
+def check_noise(res, base, tol):
+    """Metricas cuya dispersion no permite decidir con esta tolerancia."""
+    noisy = []
+    for name, data in (("actual", res), ("base", base)):
+        if len(data.get("runs", [])) < MIN_RUNS:
+            noisy.append("%s: %d corridas (minimo %d)" % (name, len(data.get("runs", [])), MIN_RUNS))
+            continue
+        for key in GATED:
+            if data["spread"][key] >= tol:
+                noisy.append("%s: %s dispersion %.0f%% >= %.0f%%" %
+                             (name, key, data["spread"][key] * 100, tol * 100))
+    return noisy
+
+
+def check_regression(res, base, tol):
+    failures = []
+    b, r = base["median"], res["median"]
+    for key in ("p50_ms", "p95_ms"):
+        if b[key] > 0 and r[key] > b[key] * (1 + tol):
+            failures.append("%s %.1f > %.1f" % (key, r[key], b[key] * (1 + tol)))
+    key = "throughput_cmd_s"
+    if b[key] > 0 and r[key] < b[key] * (1 - tol):
+        failures.append("throughput %.2f < %.2f" % (r[key], b[key] * (1 - tol)))
+    bh = base["memory"].get("high_water")
+    rh = res["memory"].get("high_water")
+    if bh and rh and rh > bh * (1 + tol):
+        failures.append("heap high-water %d > %d" % (rh, int(bh * (1 + tol))))
+    return failures
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--host", default="0.0.0.0")
+    ap.add_argument("--telegram-port", type=int, default=8443)
+    ap.add_argument("--thingspeak-port", type=int, default=8080)
+    ap.add_argument("--no-tls", action="store_true")
+    ap.add_argument("--commands", default=DEFAULT_COMMANDS, help="lista separada por comas")
+    ap.add_argument("--bursts", type=int, default=5)
+    ap.add_argument("--burst-size", type=int, default=10)
+    ap.add_argument("--pause", type=float, default=1.0, help="segundos entre rafagas")
+    ap.add_argument("--runs", type=int, default=5, help="corridas de --bursts rafagas")
+    ap.add_argument("--reply-timeout", type=float, default=60.0)
+    ap.add_argument("--wait-device", type=float, default=120.0)
+    ap.add_argument("--out", help="guardar resultados en JSON")
+    ap.add_argument("--baseline", help="JSON de una corrida anterior")
+    ap.add_argument("--tolerance", type=float, default=0.2)
+    args = ap.parse_args()
+    if args.runs < 1:
+        ap.error("--runs debe ser al menos 1")
+
+    res = run(args)
+    if res is None:
+        return 2
+    print_report(res)
+
+    if args.out:
+        with open(args.out, "w") as f:
+            json.dump(res, f, indent=2)
+
+    status = 0
+    if res["timeouts"] > 0:
+        print("FALLA: %d comandos sin respuesta" % res["timeouts"])
+        status = 1
+    if args.baseline:
+        with open(args.baseline) as f:
+            base = json.load(f)
+        noisy = check_noise(res, base, args.tolerance)
+        failures = [] if noisy else check_regression(res, base, args.tolerance)
+        for msg in noisy:
+            print("RUIDO: " + msg)
+        for msg in failures:
+            print("REGRESION: " + msg)
+        if noisy:
+            print("Sin decision: repetir con mas --runs / --bursts o con menos interferencia")
+            status = status or 2
+        elif failures:
+            status = 1
+        else:
+            print("Sin regresiones (tolerancia %.0f%%)" % (args.tolerance * 100))
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
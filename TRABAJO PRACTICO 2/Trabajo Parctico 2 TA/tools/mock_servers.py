@@ -0,0 +1,279 @@
+#!/usr/bin/env python3
+"""Servidores simulados de Telegram Bot API y ThingSpeak para pruebas offline.
+
+Implementan solo lo que usa el firmware de TP2:
+  - Telegram (HTTPS): getUpdates, sendMessage, sendPhoto (multipart)
+    (+ cualquier otro metodo -> ok)
+  - ThingSpeak (HTTP): /update con api_key y field1..field8
+
+Uso directo (queda escuchando, los comandos se inyectan desde stdin):
+    python3 tools/mock_servers.py --telegram-port 8443 --thingspeak-port 8080
+
+Normalmente lo levanta tools/bench.py.
+"""
+
+import argparse
+import email.parser
+import email.policy
+import json
+import os
+import ssl
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+
+class MockState:
+    """Estado compartido: cola de updates y respuestas enviadas por el bot."""
+
+    def __init__(self, thingspeak_min_interval=0.0):
+        self.lock = threading.Condition()
+        self.next_update_id = 1
+        self.pending = []          # updates aun no confirmados por offset
+        self.replies = []          # (instante, chat_id, texto)
+        self.photos = []           # contenido de cada sendPhoto recibido
+        self.polls = 0
+        self.last_poll = None
+        self.thingspeak_entries = 0
+        self.thingspeak_last = None
+        self.thingspeak_min_interval = thingspeak_min_interval
+        self.thingspeak_writes = []
+
+    def inject(self, text, chat_id):
+        """Encola un mensaje; devuelve (update_id, instante) para medir la latencia."""
+        with self.lock:
+            update_id = self.next_update_id
+            self.next_update_id += 1
+            now = time.monotonic()
+            self.pending.append({
+                "update_id": update_id,
+                "message": {
+                    "message_id": update_id,
+                    "from": {"id": chat_id, "is_bot": False, "first_name": "Bench"},
+                    "chat": {"id": chat_id, "type": "private", "first_name": "Bench"},
+                    "date": int(time.time()),
+                    "text": text,
+                },
+            })
+            self.lock.notify_all()
+            return update_id, now
+
+    def get_updates(self, offset, limit, timeout):
+        deadline = time.monotonic() + timeout
+        with self.lock:
+            self.polls += 1
+            self.last_poll = time.monotonic()
+            # El bot recuerda el ultimo update_id entre corridas: continuar desde ahi
+            if not self.pending and offset > self.next_update_id:
+                self.next_update_id = offset
+            # offset confirma todo lo anterior
+            self.pending = [u for u in self.pending if u["update_id"] >= offset]
+            while not self.pending and timeout > 0:
+                left = deadline - time.monotonic()
+                if left <= 0:
+                    break
+                self.lock.wait(left)
+            return self.pending[:limit]
+
+    def add_reply(self, chat_id, text):
+        with self.lock:
+            self.replies.append((time.monotonic(), str(chat_id), text))
+            self.lock.notify_all()
+
+    def thingspeak_write(self, fields):
+        with self.lock:
+            now = time.monotonic()
+            if (self.thingspeak_last is not None and
+                    now - self.thingspeak_last < self.thingspeak_min_interval):
+                return 0
+            self.thingspeak_last = now
+            self.thingspeak_entries += 1
+            self.thingspeak_writes.append((now, fields))
+            return self.thingspeak_entries
+
+
+def _multipart_params(ctype, body):
+    """Campos de texto como str, archivos como bytes."""
+    msg = email.parser.BytesParser(policy=email.policy.HTTP).parsebytes(
+        b"Content-Type: " + ctype.encode() + b"\r\n\r\n" + body)
+    params = {}
+    for part in msg.iter_parts():
+        name = part.get_param("name", header="content-disposition")
+        if not name:
+            continue
+        data = part.get_payload(decode=True) or b""
+        params[name] = data if part.get_filename() else data.decode("utf-8", "replace")
+    return params
+
+
+def _request_params(handler):
+    """Une query string, JSON, form-urlencoded y multipart en un solo dict."""
+    url = urlparse(handler.path)
+    params = {k: v[-1] for k, v in parse_qs(url.query).items()}
+    length = int(handler.headers.get("Content-Length") or 0)
+    if length > 0:
+        raw = handler.rfile.read(length)
+        body = raw.decode("utf-8", "replace")
+        ctype = handler.headers.get("Content-Type", "")
+        if ctype.startswith("multipart/"):
+            params.update(_multipart_params(ctype, raw))
+        elif "json" in ctype:
+            try:
+                params.update(json.loads(body))
+            except ValueError:
+                pass
+        else:
+            params.update({k: v[-1] for k, v in parse_qs(body).items()})
+    return url.path, params
+
+
+class _Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    state = None
+
+    def log_message(self, fmt, *args):
+        pass
+
+    def _send(self, code, body, ctype):
+        data = body.encode("utf-8")
+        self.send_response(code)
+        self.send_header("Content-Type", ctype)
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+
+class TelegramHandler(_Handler):
+    def _handle(self):
+        path, params = _request_params(self)
+        # /bot<token>/<metodo>
+        method = path.rsplit("/", 1)[-1]
+        if method == "getUpdates":
+            updates = self.state.get_updates(int(params.get("offset", 0)),
+                                             int(params.get("limit", 100)),
+                                             float(params.get("timeout", 0)))
+            self._send(200, json.dumps({"ok": True, "result": updates}), "application/json")
+        elif method == "sendMessage":
+            self.state.add_reply(params.get("chat_id", ""), params.get("text", ""))
+            result = {"message_id": int(time.time() * 1000) & 0x7FFFFFFF,
+                      "chat": {"id": params.get("chat_id", "")},
+                      "text": params.get("text", "")}
+            self._send(200, json.dumps({"ok": True, "result": result}), "application/json")
+        elif method in ("sendPhoto", "sendDocument"):
+            data = params.get("photo", params.get("document", b""))
+            if not isinstance(data, bytes):
+                data = b""
+            self.state.add_reply(params.get("chat_id", ""), "[%s %d bytes]" % (method, len(data)))
+            self.state.photos.append(data)
+            result = {"message_id": int(time.time() * 1000) & 0x7FFFFFFF,
+                      "chat": {"id": params.get("chat_id", "")},
+                      "photo": [{"file_id": "mock", "file_size": len(data)}]}
+            self._send(200, json.dumps({"ok": True, "result": result}), "application/json")
+        else:
+            self._send(200, json.dumps({"ok": True, "result": True}), "application/json")
+
+    do_GET = _handle
+    do_POST = _handle
+
+
+class ThingSpeakHandler(_Handler):
+    def _handle(self):
+        path, params = _request_params(self)
+        if path.rstrip("/") != "/update" or "api_key" not in params:
+            self._send(400, "0", "text/plain")
+            return
+        fields = {k: v for k, v in params.items() if k.startswith("field")}
+        entry = self.state.thingspeak_write(fields)
+        self._send(200, str(entry), "text/plain")
+
+    do_GET = _handle
+    do_POST = _handle
+
+
+def _self_signed_context():
+    """Certificado autofirmado temporal; el firmware usa setInsecure()."""
+    tmp = tempfile.mkdtemp(prefix="mock_tls_")
+    cert = os.path.join(tmp, "cert.pem")
+    key = os.path.join(tmp, "key.pem")
+    subprocess.run(["openssl", "req", "-x509", "-newkey", "rsa:2048", "-nodes",
+                    "-keyout", key, "-out", cert, "-days", "1",
+                    "-subj", "/CN=api.telegram.org"],
+                   check=True, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    ctx = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    ctx.load_cert_chain(cert, key)
+    return ctx
+
+
+class MockServers:
+    def __init__(self, host="0.0.0.0", telegram_port=8443, thingspeak_port=8080,
+                 tls=True, thingspeak_min_interval=0.0):
+        self.state = MockState(thingspeak_min_interval)
+        tg_handler = type("TG", (TelegramHandler,), {"state": self.state})
+        ts_handler = type("TS", (ThingSpeakHandler,), {"state": self.state})
+        self.telegram = ThreadingHTTPServer((host, telegram_port), tg_handler)
+        self.thingspeak = ThreadingHTTPServer((host, thingspeak_port), ts_handler)
+        self.telegram.daemon_threads = True
+        self.thingspeak.daemon_threads = True
+        if tls:
+            ctx = _self_signed_context()
+            self.telegram.socket = ctx.wrap_socket(self.telegram.socket, server_side=True)
+        self._threads = []
+
+    def start(self):
+        for srv in (self.telegram, self.thingspeak):
+            t = threading.Thread(target=srv.serve_forever, daemon=True)
+            t.start()
+            self._threads.append(t)
+        return self
+
+    def stop(self):
+        for srv in (self.telegram, self.thingspeak):
+            srv.shutdown()
+            srv.server_close()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--host", default="0.0.0.0")
+    ap.add_argument("--telegram-port", type=int, default=8443)
+    ap.add_argument("--thingspeak-port", type=int, default=8080)
+    ap.add_argument("--no-tls", action="store_true", help="Telegram en HTTP plano")
+    ap.add_argument("--chat-id", type=int, default=1000)
+    args = ap.parse_args()
+
+    servers = MockServers(args.host, args.telegram_port, args.thingspeak_port,
+                          tls=not args.no_tls).start()
+    print("Telegram mock en :%d, ThingSpeak mock en :%d" %
+          (args.telegram_port, args.thingspeak_port))
+    print("Escribir comandos (/dht22, /led23on, ...) para enviarlos al bot")
+
+    seen = 0
+
+    def printer():
+        nonlocal seen
+        while True:
+            with servers.state.lock:
+                servers.state.lock.wait(1.0)
+                new = servers.state.replies[seen:]
+                seen = len(servers.state.replies)
+            for _, chat, text in new:
+                print("<- [%s] %s" % (chat, text.replace("\n", " | ")))
+
+    threading.Thread(target=printer, daemon=True).start()
+    try:
+        for line in sys.stdin:
+            line = line.strip()
+            if line:
+                servers.state.inject(line, args.chat_id)
+    except KeyboardInterrupt:
+        pass
+    servers.stop()
+
+
+if __name__ == "__main__":
+    main()
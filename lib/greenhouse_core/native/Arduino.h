@@ -0,0 +1,93 @@
+/* Arduino.h minimo para los tests nativos (pio test -e native)
+   Alcanza para compilar lib/greenhouse_core y los modulos sin hardware:
+   - Serial: entrada cargada por el test con feed(), salida guardada en out
+   - digitalWrite / pinMode guardan el estado en pinLevel[] / pinModeOf[]
+   - analogRead devuelve analogValue[pin], que fija el test
+   - String: construccion, concatenacion y busqueda basicas
+   No se usa en el firmware: src/ de la libreria no lo incluye en su ruta.
+*/
+#pragma once
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+using std::max;
+using std::min;
+
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+
+const int NATIVE_PINS = 40;
+
+inline uint8_t pinLevel[NATIVE_PINS];
+inline uint8_t pinModeOf[NATIVE_PINS];
+inline int analogValue[NATIVE_PINS];
+inline unsigned long nativeMillis = 0;
+
+inline void pinMode(uint8_t pin, uint8_t mode) { pinModeOf[pin] = mode; }
+inline void digitalWrite(uint8_t pin, uint8_t val) { pinLevel[pin] = val; }
+inline int digitalRead(uint8_t pin) { return pinLevel[pin]; }
+inline int analogRead(uint8_t pin) { return analogValue[pin]; }
+inline unsigned long millis() { return nativeMillis; }
+
+class String {
+public:
+  String(const char* s = "") : s(s) {}
+  String(char c) : s(1, c) {}
+  String(int v) : s(std::to_string(v)) {}
+  String(unsigned v) : s(std::to_string(v)) {}
+  String(long v) : s(std::to_string(v)) {}
+  String(unsigned long v) : s(std::to_string(v)) {}
+
+  const char* c_str() const { return s.c_str(); }
+  size_t length() const { return s.size(); }
+  int indexOf(const char* o, size_t from = 0) const {
+    size_t i = s.find(o, from);
+    return i == std::string::npos ? -1 : (int)i;
+  }
+  bool operator==(const char* o) const { return s == o; }
+  String& operator+=(const String& o) {
+    s += o.s;
+    return *this;
+  }
+
+  friend String operator+(String a, const String& b) { return a += b; }
+
+private:
+  std::string s;
+};
+
+class NativeSerial {
+public:
+  std::string in;
+  std::string out;
+
+  void begin(unsigned long) {}
+  void feed(const char* s) { in += s; }
+  int available() const { return (int)(in.size() - pos); }
+  int read() { return pos < in.size() ? (uint8_t)in[pos++] : -1; }
+  size_t print(const char* s) {
+    out += s;
+    return strlen(s);
+  }
+  size_t println(const char* s = "") { return print(s) + print("\n"); }
+
+  void reset() {
+    in.clear();
+    out.clear();
+    pos = 0;
+  }
+
+private:
+  size_t pos = 0;
+};
+
+inline NativeSerial Serial;
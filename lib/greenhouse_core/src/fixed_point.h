@@ -0,0 +1,93 @@
+/* Punto fijo para temperatura / humedad
+   - centi_t: centesimas (2534 = 25.34 C o 25.34 %)
+   - Formateo y parseo solo con enteros: no arrastra printf de floats
+   El unico float que queda es el que devuelve la libreria DHT, se convierte
+   al leer (centiFromFloat).
+   No depende de Arduino: se puede compilar en el host.
+*/
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int16_t centi_t;
+
+static const centi_t CENTI_NAN = INT16_MIN;
+
+inline bool centiValid(int32_t v) {
+  return v != CENTI_NAN;
+}
+
+inline centi_t centiFromFloat(float v) {
+  if (isnan(v)) return CENTI_NAN;
+  return (centi_t)(v >= 0 ? v * 100.0f + 0.5f : v * 100.0f - 0.5f);
+}
+
+// Escribe v / 10^scale con 'decimals' decimales (decimals <= scale <= 4),
+// redondeando. buf debe tener al menos 14 bytes. Devuelve el largo.
+inline size_t fixedToStr(char* buf, int32_t v, uint8_t scale, uint8_t decimals) {
+  static const uint32_t POW10[5] = { 1, 10, 100, 1000, 10000 };
+  if (decimals > scale) decimals = scale;
+
+  bool neg = v < 0;
+  uint32_t u = neg ? (uint32_t)(-(int64_t)v) : (uint32_t)v;
+  uint32_t div = POW10[scale - decimals];
+  u = (u + div / 2) / div;
+  if (u == 0) neg = false; // sin "-0.0"
+
+  char tmp[14];
+  size_t n = 0;
+  for (uint8_t i = 0; i < decimals; i++) {
+    tmp[n++] = (char)('0' + u % 10);
+    u /= 10;
+  }
+  if (decimals > 0) tmp[n++] = '.';
+  do {
+    tmp[n++] = (char)('0' + u % 10);
+    u /= 10;
+  } while (u > 0);
+  if (neg) tmp[n++] = '-';
+
+  for (size_t i = 0; i < n; i++) buf[i] = tmp[n - 1 - i];
+  buf[n] = '\0';
+  return n;
+}
+
+inline size_t centiToStr(char* buf, int32_t v, uint8_t decimals = 1) {
+  return fixedToStr(buf, v, 2, decimals);
+}
+
+// "25", "25.5", "-3.25" -> centesimas. Los decimales de mas se truncan.
+inline bool parseCenti(const char* s, int32_t& out) {
+  while (*s == ' ') s++;
+  bool neg = false;
+  if (*s == '-' || *s == '+') neg = (*s++ == '-');
+
+  int32_t whole = 0;
+  int digits = 0;
+  while (*s >= '0' && *s <= '9') {
+    whole = whole * 10 + (*s++ - '0');
+    if (++digits > 6) return false;
+  }
+  int32_t frac = 0;
+  int fracDigits = 0;
+  if (*s == '.' || *s == ',') {
+    s++;
+    while (*s >= '0' && *s <= '9') {
+      if (fracDigits < 2) {
+        frac = frac * 10 + (*s - '0');
+        fracDigits++;
+      }
+      s++;
+      digits++;
+    }
+  }
+  while (*s == ' ') s++;
+  if (digits == 0 || *s != '\0') return false;
+
+  if (fracDigits == 1) frac *= 10;
+  int32_t v = whole * 100 + frac;
+  out = neg ? -v : v;
+  return true;
+}
@@ -0,0 +1,98 @@
+/* Politica de comandos por Serial
+   - Arma la linea con lo que haya en cada loop(): no bloquea como
+     readStringUntil()
+   - La linea termina con '\n', con '\r' o tras IDLE_MS sin caracteres nuevos
+     (monitor serie en "No line ending", como el timeout de readStringUntil)
+   - Tabla de comandos: nombre exacto, o prefijo si el nombre termina en
+     espacio ("TEMP " recibe "25.5" como argumento)
+   - UPPERCASE pasa la linea a mayusculas antes de buscar (TP1)
+   - Una linea mas larga que LINE_LEN - 1 se descarta entera (va a onUnknown
+     cortada) para no ejecutar un comando truncado
+*/
+#pragma once
+
+#include <Arduino.h>
+
+struct CommandEntry {
+  const char* name;
+  void (*fn)(const char* args);
+};
+
+template <size_t LINE_LEN = 48, bool UPPERCASE = false>
+class SerialCommands {
+public:
+  enum { IDLE_MS = 1000 };
+
+  typedef void (*UnknownFn)(const char* line);
+
+  template <size_t N>
+  void setTable(const CommandEntry (&entries)[N], UnknownFn unknown = nullptr) {
+    table = entries;
+    count = N;
+    onUnknown = unknown;
+  }
+
+  void begin() {
+    len = 0;
+    overflow = false;
+  }
+
+  void loop(unsigned long now) {
+    while (Serial.available()) {
+      char c = (char)Serial.read();
+      lastChar = now;
+      if (c == '\n' || c == '\r') {
+        endLine();
+      } else if (len < LINE_LEN - 1) {
+        line[len++] = UPPERCASE ? (char)toupper(c) : c;
+      } else {
+        overflow = true;
+      }
+    }
+    // Sin fin de linea: se ejecuta lo recibido tras IDLE_MS de silencio
+    if ((len > 0 || overflow) && now - lastChar >= IDLE_MS) endLine();
+  }
+
+  // Busca el comando en la tabla; devuelve false si no existe
+  bool dispatch(const char* cmd) {
+    if (*cmd == '\0') return true;
+    for (size_t i = 0; i < count; i++) {
+      const char* name = table[i].name;
+      size_t n = strlen(name);
+      bool prefix = n > 0 && name[n - 1] == ' ';
+      if (prefix ? strncmp(cmd, name, n) == 0 : strcmp(cmd, name) == 0) {
+        table[i].fn(prefix ? cmd + n : "");
+        return true;
+      }
+    }
+    if (onUnknown) onUnknown(cmd);
+    return false;
+  }
+
+private:
+  void endLine() {
+    line[len] = '\0';
+    len = 0;
+    if (overflow) {
+      overflow = false;
+      if (onUnknown) onUnknown(trim(line));
+      return;
+    }
+    dispatch(trim(line));
+  }
+
+  static char* trim(char* s) {
+    while (*s == ' ') s++;
+    size_t n = strlen(s);
+    while (n > 0 && s[n - 1] == ' ') s[--n] = '\0';
+    return s;
+  }
+
+  const CommandEntry* table = nullptr;
+  size_t count = 0;
+  UnknownFn onUnknown = nullptr;
+  char line[LINE_LEN];
+  size_t len = 0;
+  bool overflow = false;
+  unsigned long lastChar = 0;
+};
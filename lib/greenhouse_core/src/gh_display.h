@@ -0,0 +1,46 @@
+/* Politica de display: SSD1306 por I2C
+   - begin() inicia el bus en PIN_SDA / PIN_SCL y el display
+   - I2C_HZ se pasa al constructor de Adafruit_SSD1306, que lo aplica en
+     cada display() (un Wire.setClock() externo se pisaria)
+   - showText(): titulo en tamaño 1 y cuerpo en tamaño 2, el formato de las
+     pantallas simples de ambos TPs; gfx() da acceso al objeto para dibujar
+     pantallas propias
+*/
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
+
+template <uint8_t PIN_SDA, uint8_t PIN_SCL, uint8_t ADDR = 0x3C, uint32_t I2C_HZ = 400000,
+          uint8_t SCREEN_W = 128, uint8_t SCREEN_H = 64>
+class Ssd1306Display {
+public:
+  Ssd1306Display() : oled(SCREEN_W, SCREEN_H, &Wire, -1, I2C_HZ, I2C_HZ) {}
+
+  bool begin() {
+    Wire.begin(PIN_SDA, PIN_SCL);
+    Wire.setClock(I2C_HZ);
+    if (!oled.begin(SSD1306_SWITCHCAPVCC, ADDR)) return false;
+    oled.clearDisplay();
+    oled.setTextColor(SSD1306_WHITE);
+    return true;
+  }
+
+  void showText(const char* title, const char* body) {
+    oled.clearDisplay();
+    oled.setTextSize(1);
+    oled.setCursor(0,0);
+    oled.println(title);
+    oled.setTextSize(2);
+    oled.setCursor(0,20);
+    oled.println(body);
+    oled.display();
+  }
+
+  Adafruit_SSD1306& gfx() { return oled; }
+
+private:
+  Adafruit_SSD1306 oled;
+};
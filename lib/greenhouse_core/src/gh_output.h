@@ -0,0 +1,61 @@
+/* Politicas de actuadores
+   - DigitalOutput: salida encendido / apagado (LEDs, rele)
+   - BlinkOutput: mientras esta activa parpadea con el periodo dado
+   El firmware arma su struct de actuadores con estas salidas y un begin() /
+   loop(now) que las recorre.
+*/
+#pragma once
+
+#include <Arduino.h>
+
+template <uint8_t PIN>
+class DigitalOutput {
+public:
+  void begin() {
+    pinMode(PIN, OUTPUT);
+    digitalWrite(PIN, LOW);
+  }
+
+  void set(bool on) {
+    state = on;
+    digitalWrite(PIN, on ? HIGH : LOW);
+  }
+
+  bool get() const { return state; }
+  void loop(unsigned long) {}
+
+private:
+  bool state = false;
+};
+
+template <uint8_t PIN, unsigned long PERIOD_MS>
+class BlinkOutput {
+public:
+  void begin() {
+    pinMode(PIN, OUTPUT);
+    digitalWrite(PIN, LOW);
+  }
+
+  // Al apagarse deja el pin en LOW
+  void set(bool on) {
+    if (!on && active) {
+      level = false;
+      digitalWrite(PIN, LOW);
+    }
+    active = on;
+  }
+
+  bool get() const { return active; }
+
+  void loop(unsigned long now) {
+    if (!active || now - lastToggle < PERIOD_MS) return;
+    lastToggle = now;
+    level = !level;
+    digitalWrite(PIN, level ? HIGH : LOW);
+  }
+
+private:
+  bool active = false;
+  bool level = false;
+  unsigned long lastToggle = 0;
+};
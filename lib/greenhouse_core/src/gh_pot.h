@@ -0,0 +1,25 @@
+/* Politica de potenciometro: entrada analogica con atenuacion de 11 dB
+   (rango completo 0..3.3 V en el ESP32)
+*/
+#pragma once
+
+#include <Arduino.h>
+
+template <uint8_t PIN>
+class AnalogPot {
+public:
+  void begin() {
+#if defined(ARDUINO_ARCH_ESP32)
+    analogSetPinAttenuation(PIN, ADC_11db);
+#endif
+  }
+
+  int raw() const { return analogRead(PIN); }
+
+  // Lectura en milivolts (0..3300)
+  static int32_t toMillivolts(int raw) { return (int32_t)raw * 3300 / 4095; }
+  int32_t millivolts() const { return toMillivolts(raw()); }
+
+  // Lectura escalada linealmente a [lo, hi] (ej. centesimas)
+  static int32_t toRange(int raw, int32_t lo, int32_t hi) { return lo + (int32_t)raw * (hi - lo) / 4095; }
+};
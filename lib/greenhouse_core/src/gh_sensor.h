@@ -0,0 +1,26 @@
+/* Politica de sensor: DHT22 (o DHT11) en un pin
+   La libreria DHT entrega float: se pasa a centesimas una sola vez al leer.
+*/
+#pragma once
+
+#include <Arduino.h>
+#include <DHT.h>
+
+#include "fixed_point.h"
+
+template <uint8_t PIN, uint8_t TYPE = DHT22>
+class Dht22Sensor {
+public:
+  Dht22Sensor() : dht(PIN, TYPE) {}
+
+  void begin() { dht.begin(); }
+
+  bool read(centi_t& t, centi_t& h) {
+    h = centiFromFloat(dht.readHumidity());
+    t = centiFromFloat(dht.readTemperature());
+    return centiValid(h) && centiValid(t);
+  }
+
+private:
+  DHT dht;
+};
@@ -0,0 +1,83 @@
+/* GreenhouseCore: nucleo comun de TP1 y TP2
+   Se arma con clases de politica, una por funcion:
+     Sensor    -> Dht22Sensor<pin>                 (gh_sensor.h)
+     Pot       -> AnalogPot<pin> / NoPot           (gh_pot.h)
+     Display   -> Ssd1306Display<...> / NoDisplay  (gh_display.h)
+     Actuators -> struct del firmware con DigitalOutput / BlinkOutput (gh_output.h)
+     Commands  -> SerialCommands<...> / NoCommands (gh_commands.h)
+   Todo es header-only y resuelto en compilacion: una politica No* es una
+   clase vacia con metodos inline vacios, asi la funcion que no se usa no
+   deja codigo ni RAM en la imagen.
+
+   Requisitos de cada politica: begin() (Display::begin devuelve bool)
+   y loop(now) para Actuators y Commands.
+
+   Tests en la PC (incluye un nucleo solo con politicas No*):
+   pio test -e native desde TP1, con el stub de Arduino.h de native/.
+*/
+#pragma once
+
+#include <Arduino.h>
+
+#include "fixed_point.h"
+
+// --------------------- Politicas vacias ---------------------
+struct NoPot {
+  void begin() {}
+  int raw() const { return 0; }
+  int32_t millivolts() const { return 0; }
+};
+
+struct NoDisplay {
+  bool begin() { return true; }
+  void showText(const char*, const char*) {}
+};
+
+struct NoActuators {
+  void begin() {}
+  void loop(unsigned long) {}
+};
+
+struct NoCommands {
+  void begin() {}
+  void loop(unsigned long) {}
+};
+
+// --------------------- Nucleo ---------------------
+template <class Sensor, class Pot = NoPot, class Display = NoDisplay,
+          class Actuators = NoActuators, class Commands = NoCommands>
+class GreenhouseCore {
+public:
+  Sensor sensor;
+  Pot pot;
+  Display display;
+  Actuators actuators;
+  Commands commands;
+
+  // Ultima lectura valida (centesimas)
+  centi_t temp = CENTI_NAN;
+  centi_t hum = CENTI_NAN;
+
+  // false si el display no responde; el resto arranca igual
+  bool begin() {
+    bool displayOk = display.begin();
+    sensor.begin();
+    pot.begin();
+    actuators.begin();
+    commands.begin();
+    return displayOk;
+  }
+
+  void loop(unsigned long now) {
+    actuators.loop(now);
+    commands.loop(now);
+  }
+
+  // Lee el sensor; si la lectura es valida actualiza temp / hum
+  bool readSensor(centi_t& t, centi_t& h) {
+    if (!sensor.read(t, h)) return false;
+    temp = t;
+    hum = h;
+    return true;
+  }
+};
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Reporte de flash / RAM de TP1 y TP2: antes vs despues.
+
+Compila cada firmware (entorno esp32dev) en una revision "antes" y en el
+arbol actual, y compara los totales que informa PlatformIO:
+    python3 tools/footprint.py
+    python3 tools/footprint.py --before <commit> --out footprint.json
+
+Por defecto "antes" es el commit anterior al que agrego lib/greenhouse_core.
+La revision se arma en un git worktree temporal, el arbol actual no se toca.
+Requiere pio en el PATH.
+"""
+
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+PROJECTS = [
+    ("TP1", "TRABAJO PARCTICO 1"),
+    ("TP2", os.path.join("TRABAJO PRACTICO 2", "Trabajo Parctico 2 TA")),
+]
+ENV = "esp32dev"
+
+# "RAM:   [=         ]  13.6% (used 44660 bytes from 327680 bytes)"
+SIZE_RE = re.compile(r"^(RAM|Flash):.*\(used (\d+) bytes from (\d+) bytes\)", re.M)
+
+
+def git(*args, cwd=ROOT):
+    return subprocess.check_output(["git"] + list(args), cwd=cwd, text=True).strip()
+
+
+def default_before():
+    added = git("log", "--diff-filter=A", "--format=%H", "--", "lib/greenhouse_core/library.json")
+    if not added:
+        sys.exit("No se encontro el commit de lib/greenhouse_core; usar --before")
+    return added.splitlines()[-1] + "~1"
+
+
+def build(tree, project):
+    """Compila un proyecto y devuelve {'flash': n, 'ram': n}."""
+    proc = subprocess.run(["pio", "run", "-e", ENV, "-d", os.path.join(tree, project)],
+                          stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    if proc.returncode != 0:
+        sys.stderr.write(proc.stdout[-3000:])
+        sys.exit("Fallo la compilacion de %s en %s" % (project, tree))
+    sizes = {}
+    for kind, used, _total in SIZE_RE.findall(proc.stdout):
+        sizes[kind.lower()] = int(used)
+    return sizes
+
+
+def measure(tree):
+    return {name: build(tree, path) for name, path in PROJECTS}
+
+
+def print_report(before_rev, before, after):
+    print("Footprint %s: antes = %s, despues = arbol actual" % (ENV, before_rev))
+    print("%-4s %-6s %10s %10s %10s" % ("", "", "antes", "despues", "delta"))
+    for name, _path in PROJECTS:
+        for kind in ("flash", "ram"):
+            b = before[name].get(kind, 0)
+            a = after[name].get(kind, 0)
+            print("%-4s %-6s %10d %10d %+10d" % (name, kind, b, a, a - b))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--before", help="revision de referencia (default: antes de lib/greenhouse_core)")
+    ap.add_argument("--out", help="guardar el resultado en JSON")
+    args = ap.parse_args()
+
+    before_rev = args.before or default_before()
+    tmp = tempfile.mkdtemp(prefix="footprint-")
+    worktree = os.path.join(tmp, "before")
+    git("worktree", "add", "--detach", worktree, before_rev)
+    try:
+        before = measure(worktree)
+    finally:
+        git("worktree", "remove", "--force", worktree)
+        shutil.rmtree(tmp, ignore_errors=True)
+    after = measure(ROOT)
+
+    print_report(before_rev, before, after)
+    if args.out:
+        with open(args.out, "w") as f:
+            json.dump({"env": ENV, "before_rev": before_rev, "before": before, "after": after}, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()